@@ -15,6 +15,8 @@
 #include <tuple>
 #include <cstdint>
 
+#include "RevCheckpoint.h"
+
 #ifndef _PANEXEC_MAX_ENTRY_
 #define _PANEXEC_MAX_ENTRY_ 64
 #endif
@@ -49,6 +51,12 @@ namespace SST {
       /// PanExec: get execution entry
       PanStatus GetNextEntry(uint64_t *Addr, unsigned *Idx);
 
+      /// PanExec: write the execution queue to a checkpoint
+      void Checkpoint(RevCheckpoint &C);
+
+      /// PanExec: restore the execution queue from a checkpoint
+      void Restore(RevCheckpoint &C);
+
     private:
       // private data members
       unsigned CurEntry;
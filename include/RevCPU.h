@@ -41,6 +41,9 @@
 
 #define _MAX_PAN_TEST_ 11
 
+/// RevCPU: initial size of the replay payload buffer; larger records wait for the memory controller to drain
+#define _REV_REPLAY_BUF_ 4096
+
 namespace SST {
   namespace RevCPU {
     class RevCPU : public SST::Component {
@@ -67,6 +70,9 @@ namespace SST {
       /// RevCPU: test harness clock tick function
       bool clockTickPANTest( SST::Cycle_t currentCycle );
 
+      /// RevCPU: trace replay clock tick function
+      bool clockTickReplay( SST::Cycle_t currentCycle );
+
       // -------------------------------------------------------
       // RevCPU Component Registration Data
       // -------------------------------------------------------
@@ -90,17 +96,50 @@ namespace SST {
         {"args",            "Sets the argument list",                       ""},
         {"numCores",        "Number of RISC-V cores to instantiate",        "1" },
         {"memSize",         "Main memory size in bytes",                    "1073741824"},
+        {"pageSize",        "Page size in bytes; must be a power of two",   "262144"},
+        {"tlbSize",         "Number of TLB entries per core",               "512"},
+        {"tlbWays",         "TLB associativity per core",                   "8"},
         {"startAddr",       "Starting PC of the target core",               "core:0x80000000"},
         {"startSymbol",     "Starting symbol name of the target core",      "core:symbol"},
         {"machine",         "RISC-V machine model of the target core",      "core:G"},
         {"memCost",         "Memory latency range in cycles min:max",       "core:0:10"},
+        {"memRegions",      "Region-specific memory latency base:size:min:max[:bytesPerCycle]", "[]"},
         {"prefetchDepth",   "Instruction prefetch depth per core",          "core:1"},
         {"table",           "Instruction cost table",                       "core:/path/to/table"},
         {"enable_nic",      "Enable the internal RevNIC",                   "0"},
         {"enable_pan",      "Enable PAN network endpoint",                  "0"},
         {"enable_test",     "Enable PAN network endpoint test",             "0"},
         {"enable_pan_stats","Enable PAN network statistics",                "1"},
-        {"enable_memH",     "Enable memHierarchy",                          "0"},
+        {"enable_memH",     "Enable the memory controller set in the memory slot", "0"},
+        {"enable_hugepages","Back the internal memory with transparent huge pages", "0"},
+        {"trace_file",      "Write a binary memory access trace to the target file", ""},
+        {"replay_file",     "Replay a binary memory access trace instead of executing a program", ""},
+        {"replay_timing",   "Issue replayed accesses at their recorded cycles; 0 issues them as fast as possible", "1"},
+        {"replay_max_pending","Memory controller requests in flight before replay stalls", "64"},
+        {"trace_buffer",    "Memory trace buffer size in bytes",            "1048576"},
+        {"trace_min_addr",  "Lowest address written to the memory trace",   "0x0"},
+        {"trace_max_addr",  "Highest address written to the memory trace",  "0xFFFFFFFFFFFFFFFF"},
+        {"trace_start",     "First cycle written to the memory trace",      "0"},
+        {"trace_stop",      "Last cycle written to the memory trace",       "0xFFFFFFFFFFFFFFFF"},
+        {"heatmap_file",    "Write per-page heat map statistics to the target file", ""},
+        {"heatmap_interval","Cycles between heat map dumps; 0 dumps once at the end", "0"},
+        {"heatmap_top",     "Number of hot pages listed per heat map dump", "16"},
+        {"checkpoint_file", "Write a checkpoint of the simulation to the target file", ""},
+        {"checkpoint_cycle","Cycle at or after which the checkpoint is taken", "0"},
+        {"checkpoint_exit", "End the simulation once the checkpoint is written", "0"},
+        {"restore_file",    "Resume the simulation from the target checkpoint", ""},
+        {"enable_cache",    "Enable the internal cache timing model (without memHierarchy)", "0"},
+        {"cacheLineSize",   "Cache line size in bytes for every cache level", "64"},
+        {"l1Size",          "L1 data cache size in bytes",                  "32768"},
+        {"l1Ways",          "L1 cache associativity",                       "8"},
+        {"l1HitLatency",    "L1 cache hit latency in cycles",               "1"},
+        {"l1MissLatency",   "L1 cache miss latency in cycles",              "1"},
+        {"l1Shared",        "Share a single L1 cache among every core",     "0"},
+        {"l2Size",          "L2 cache size in bytes; 0 disables the L2",    "262144"},
+        {"l2Ways",          "L2 cache associativity",                       "8"},
+        {"l2HitLatency",    "L2 cache hit latency in cycles",               "10"},
+        {"l2MissLatency",   "L2 cache miss latency in cycles",              "2"},
+        {"l2Shared",        "Share a single L2 cache among every core",     "1"},
         {"enableRDMAMbox",  "Enable the RDMA mailbox",                      "1"},
         {"enable_faults",   "Enable the fault injection logic",             "0"},
         {"faults",          "Enable specific faults",                       "decode,mem,reg,alu"},
@@ -192,6 +231,14 @@ namespace SST {
         {"TLBMisses",           "TLB misses",                                           "count",  1},
         {"TLBHitsPerCore",      "TLB hits per core",                                    "count",  1},
         {"TLBMissesPerCore",    "TLB misses per core",                                  "count",  1},
+        {"SCAttemptsPerCore",   "Store conditional attempts per core",                  "count",  1},
+        {"SCFailuresPerCore",   "Failed store conditionals per core",                   "count",  1},
+        {"L1HitsPerCore",       "Cache model L1 hits per core",                         "count",  1},
+        {"L1MissesPerCore",     "Cache model L1 misses per core",                       "count",  1},
+        {"L2HitsPerCore",       "Cache model L2 hits per core",                         "count",  1},
+        {"L2MissesPerCore",     "Cache model L2 misses per core",                       "count",  1},
+        {"RegionAccessesPerCore", "Accesses to configured memory regions per core",     "count",  1},
+        {"RegionStallsPerCore", "Cycles spent waiting on memory region bandwidth per core", "cycles", 1},
       )
 
     private:
@@ -243,6 +290,24 @@ namespace SST {
       panNicAPI *PNic;                    ///< RevCPU: PAN network interface controller
       PanExec *PExec;                     ///< RevCPU: PAN execution context
       RevMemCtrl *Ctrl;                   ///< RevCPU: Rev memory controller
+      RevMemTrace *Trace;                 ///< RevCPU: memory access trace; nullptr when disabled
+      bool EnableHeatMap;                 ///< RevCPU: per-page heat map statistics are enabled
+      uint64_t HeatMapInterval;           ///< RevCPU: cycles between heat map dumps; 0 for a single final dump
+
+      std::string CheckpointFile;         ///< RevCPU: checkpoint output file; empty when disabled
+      uint64_t CheckpointCycle;           ///< RevCPU: cycle at or after which the checkpoint is taken
+      bool CheckpointExit;                ///< RevCPU: end the simulation once the checkpoint is written
+      bool CheckpointDone;                ///< RevCPU: the checkpoint has been written
+      bool Restored;                      ///< RevCPU: the simulation was resumed from a checkpoint
+
+      RevMemTraceReader *Replay;          ///< RevCPU: trace being replayed; nullptr when executing a program
+      bool ReplayTiming;                  ///< RevCPU: issue replayed accesses at their recorded cycles
+      uint64_t ReplayMaxPending;          ///< RevCPU: memory controller requests allowed before replay stalls
+      bool ReplayHasNext;                 ///< RevCPU: ReplayNext holds a record that has not been issued
+      RevTraceRecord ReplayNext;          ///< RevCPU: next record to replay
+      uint64_t ReplayFirstCycle;          ///< RevCPU: recorded cycle of the first replayed record
+      uint64_t ReplayStartCycle;          ///< RevCPU: cycle at which the replay began
+      std::vector<uint8_t> ReplayBuf;     ///< RevCPU: payload and response sink for replayed accesses
 
       std::queue<std::pair<panNicEvent *,int>> SendMB;  ///< RevCPU: outgoing command mailbox; pair<Cmd,Dest>
       std::queue<std::pair<uint32_t,char *>> ZeroRqst;  ///< RevCPU: tracks incoming zero address put requests; pair<Size,Data>
@@ -324,6 +389,14 @@ namespace SST {
       std::vector<Statistic<uint64_t>*> FloatsExec;
       std::vector<Statistic<uint64_t>*> TLBMissesPerCore;
       std::vector<Statistic<uint64_t>*> TLBHitsPerCore;
+      std::vector<Statistic<uint64_t>*> SCAttemptsPerCore;
+      std::vector<Statistic<uint64_t>*> SCFailuresPerCore;
+      std::vector<Statistic<uint64_t>*> L1HitsPerCore;
+      std::vector<Statistic<uint64_t>*> L1MissesPerCore;
+      std::vector<Statistic<uint64_t>*> L2HitsPerCore;
+      std::vector<Statistic<uint64_t>*> L2MissesPerCore;
+      std::vector<Statistic<uint64_t>*> RegionAccessesPerCore;
+      std::vector<Statistic<uint64_t>*> RegionStallsPerCore;
 
       //-------------------------------------------------------
       // -- FUNCTIONS
@@ -485,6 +558,15 @@ namespace SST {
       /// RevCPU: updates sst statistics on a per core basis
       void UpdateCoreStatistics(uint16_t coreNum);
 
+      /// RevCPU: determines whether every core and queue is drained so that a checkpoint can be taken
+      bool IsQuiescent();
+
+      /// RevCPU: write the simulation state to CheckpointFile
+      void WriteCheckpoint(SST::Cycle_t currentCycle);
+
+      /// RevCPU: resume the simulation state from the target checkpoint
+      void RestoreCheckpoint(const std::string &File);
+
     }; // class RevCPU
   } // namespace RevCPU
 } // namespace SST
@@ -0,0 +1,112 @@
+//
+// _RevCache_h_
+//
+// Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+//
+// See LICENSE in the top level directory for licensing details
+//
+
+#ifndef _SST_REVCPU_REVCACHE_H_
+#define _SST_REVCPU_REVCACHE_H_
+
+// -- C++ Headers
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+// -- SST Headers
+#include <sst/core/sst_config.h>
+#include <sst/core/output.h>
+
+#ifndef _INVALID_ADDR_
+#define _INVALID_ADDR_ 0xFFFFFFFFFFFFFFFF
+#endif
+
+namespace SST {
+  namespace RevCPU {
+
+    /// RevCacheConfig: geometry and timing of a single cache level
+    struct RevCacheConfig {
+      uint64_t Size;              ///< RevCacheConfig: capacity in bytes; 0 disables the level
+      unsigned Ways;              ///< RevCacheConfig: associativity
+      unsigned LineSize;          ///< RevCacheConfig: line size in bytes
+      unsigned HitLatency;        ///< RevCacheConfig: cycles charged on a hit
+      unsigned MissLatency;       ///< RevCacheConfig: cycles charged on a miss before the next level
+      bool Shared;                ///< RevCacheConfig: one instance shared by every core
+    };
+
+    // ----------------------------------------
+    // RevCache
+    // ----------------------------------------
+    // Tag-only set-associative cache timing model with true LRU
+    // replacement.  No data is stored; the model only decides whether
+    // an access hits so that the caller can charge a latency.  Every
+    // access allocates on a miss (loads and stores alike).
+    class RevCache {
+    public:
+      /// RevCache: constructor
+      RevCache( const RevCacheConfig &Config, SST::Output *Output );
+
+      /// RevCache: destructor
+      ~RevCache();
+
+      /// RevCache: probe and fill the line holding the target address; returns true on a hit
+      bool Access( uint64_t Addr ){
+        const uint64_t Line = Addr >> lineShift;
+        const unsigned Base = (unsigned)(Line & setMask) * ways;
+        stamp++;
+        for( unsigned w=0; w<ways; w++ ){
+          if( Tags[Base+w] == Line ){
+            LRU[Base+w] = stamp;
+            hits++;
+            return true;
+          }
+        }
+        misses++;
+        Fill(Base, Line);
+        return false;
+      }
+
+      /// RevCache: invalidate every line
+      void Flush();
+
+      /// RevCache: retrieve the hit latency
+      unsigned GetHitLatency() { return config.HitLatency; }
+
+      /// RevCache: retrieve the miss latency
+      unsigned GetMissLatency() { return config.MissLatency; }
+
+      /// RevCache: retrieve the line size
+      unsigned GetLineSize() { return config.LineSize; }
+
+      /// RevCache: retrieve the number of hits
+      uint64_t GetHits() { return hits; }
+
+      /// RevCache: retrieve the number of misses
+      uint64_t GetMisses() { return misses; }
+
+    private:
+      RevCacheConfig config;        ///< RevCache: cache geometry and timing
+      unsigned sets;                ///< RevCache: number of sets
+      unsigned ways;                ///< RevCache: number of ways per set
+      unsigned lineShift;           ///< RevCache: log2 of the line size
+      uint64_t setMask;             ///< RevCache: mask used to derive the set index
+      uint64_t stamp;               ///< RevCache: access counter used for LRU ordering
+      uint64_t hits;                ///< RevCache: number of hits
+      uint64_t misses;              ///< RevCache: number of misses
+      SST::Output *output;          ///< RevCache: output handler
+
+      std::vector<uint64_t> Tags;   ///< RevCache: line addresses [set*ways+way]
+      std::vector<uint64_t> LRU;    ///< RevCache: last access stamp [set*ways+way]
+
+      /// RevCache: replace the least recently used line in the target set
+      void Fill( unsigned Base, uint64_t Line );
+    }; // class RevCache
+  } // namespace RevCPU
+} // namespace SST
+
+#endif // _SST_REVCPU_REVCACHE_H_
+
+// EOF
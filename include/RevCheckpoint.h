@@ -0,0 +1,121 @@
+//
+// _RevCheckpoint_h_
+//
+// Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+//
+// See LICENSE in the top level directory for licensing details
+//
+
+#ifndef _SST_REVCPU_REVCHECKPOINT_H_
+#define _SST_REVCPU_REVCHECKPOINT_H_
+
+// -- C++ Headers
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <type_traits>
+
+// -- SST Headers
+#include <sst/core/sst_config.h>
+#include <sst/core/output.h>
+
+#define _REV_CKPT_MAGIC_    "REVCKPT"       ///< RevCheckpoint: file magic
+#define _REV_CKPT_VERSION_  2               ///< RevCheckpoint: file format version
+
+namespace SST {
+  namespace RevCPU {
+
+    // ----------------------------------------
+    // RevCheckpoint
+    // ----------------------------------------
+    // Sequential binary snapshot file.  Each object writes its state
+    // through Checkpoint() and reads it back in the same order through
+    // Restore(); named section markers catch any drift between the two.
+    // Values are stored in host byte order, so a checkpoint can only be
+    // restored by the same build on the same kind of host.
+    class RevCheckpoint {
+    public:
+      /// RevCheckpoint: constructor; Write creates the file, otherwise the header is validated
+      RevCheckpoint( const std::string &File, bool Write, SST::Output *Output );
+
+      /// RevCheckpoint: destructor
+      ~RevCheckpoint();
+
+      /// RevCheckpoint: true when the checkpoint is being written
+      bool IsWriting() { return writing; }
+
+      /// RevCheckpoint: write or verify a named section marker
+      void Section( const char *Name );
+
+      /// RevCheckpoint: write raw bytes
+      void PutBytes( const void *Data, size_t Len );
+
+      /// RevCheckpoint: read raw bytes
+      void GetBytes( void *Data, size_t Len );
+
+      /// RevCheckpoint: write a trivially copyable value
+      template <typename T>
+      void Put( const T &V ){
+        static_assert(std::is_trivially_copyable<T>::value, "checkpointed values must be trivially copyable");
+        PutBytes(&V, sizeof(T));
+      }
+
+      /// RevCheckpoint: read a trivially copyable value
+      template <typename T>
+      T Get(){
+        static_assert(std::is_trivially_copyable<T>::value, "checkpointed values must be trivially copyable");
+        T V;
+        GetBytes(&V, sizeof(T));
+        return V;
+      }
+
+      /// RevCheckpoint: write a vector of trivially copyable values
+      template <typename T>
+      void PutVec( const std::vector<T> &V ){
+        Put<uint64_t>(V.size());
+        if( !V.empty() )
+          PutBytes(V.data(), V.size() * sizeof(T));
+      }
+
+      /// RevCheckpoint: read a vector of trivially copyable values
+      template <typename T>
+      std::vector<T> GetVec(){
+        std::vector<T> V(Get<uint64_t>());
+        if( !V.empty() )
+          GetBytes(V.data(), V.size() * sizeof(T));
+        return V;
+      }
+
+      /// RevCheckpoint: write a string
+      void PutString( const std::string &S );
+
+      /// RevCheckpoint: read a string
+      std::string GetString();
+
+      /// RevCheckpoint: pad (write) or skip (read) to the next multiple of Align; returns the file offset
+      uint64_t AlignTo( uint64_t Align );
+
+      /// RevCheckpoint: skip Len bytes while reading
+      void Skip( uint64_t Len );
+
+      /// RevCheckpoint: retrieve the file descriptor; used to map restored pages
+      int GetFD() { return fileno(file); }
+
+      /// RevCheckpoint: retrieve the file name
+      const std::string &GetName() { return name; }
+
+    private:
+      FILE *file;                   ///< RevCheckpoint: checkpoint file
+      std::string name;             ///< RevCheckpoint: checkpoint file name
+      bool writing;                 ///< RevCheckpoint: the checkpoint is being written
+      SST::Output *output;          ///< RevCheckpoint: output handler
+    }; // class RevCheckpoint
+  } // namespace RevCPU
+} // namespace SST
+
+#endif // _SST_REVCPU_REVCHECKPOINT_H_
+
+// EOF
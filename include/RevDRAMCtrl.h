@@ -0,0 +1,275 @@
+//
+// _RevDRAMCtrl_h_
+//
+// Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+//
+// See LICENSE in the top level directory for licensing details
+//
+
+#ifndef _SST_REVCPU_REVDRAMCTRL_H_
+#define _SST_REVCPU_REVDRAMCTRL_H_
+
+// -- C++ Headers
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+
+// -- SST Headers
+#include <sst/core/sst_config.h>
+#include <sst/core/output.h>
+#include <sst/core/subcomponent.h>
+
+// -- RevCPU Headers
+#include "RevMemCtrl.h"
+
+/// RevDRAMCtrl: granularity of the sparse backing store
+#define _REV_DRAM_PAGE_ 4096
+
+namespace SST {
+  namespace RevCPU {
+
+    // ----------------------------------------
+    // RevDRAMCtrl
+    // ----------------------------------------
+    // RevMemCtrl backend with a bank/row-buffer DRAM timing model and
+    // its own backing store; no memHierarchy graph is required.  Each
+    // request reads or updates the backing store when it is sent, so
+    // program order is preserved no matter how the scheduler reorders
+    // the DRAM transactions.  The transactions only decide when the
+    // read data is delivered to RevMem and when the request retires.
+    //
+    // Addresses are mapped row:bank:column.  Every cycle the scheduler
+    // picks, among the oldest sched_window transactions, the oldest row
+    // hit to a ready bank and otherwise the oldest transaction to a
+    // ready bank (FR-FCFS).  Data returns over a single channel moving
+    // bus_bytes per cycle.  All timings are in controller cycles.
+    class RevDRAMCtrl : public RevMemCtrl {
+    public:
+      SST_ELI_REGISTER_SUBCOMPONENT_DERIVED(RevDRAMCtrl, "revcpu",
+                                            "RevDRAMCtrl",
+                                            SST_ELI_ELEMENT_VERSION(1, 0, 0),
+                                            "RISC-V Rev DRAM timing memory controller",
+                                            SST::RevCPU::RevMemCtrl
+                                           )
+
+      SST_ELI_DOCUMENT_PARAMS({ "verbose",       "Set the verbosity of output for the memory controller",      "0" },
+                              { "clock",         "Sets the clock frequency of the memory controller",          "1Ghz" },
+                              { "banks",         "Sets the number of DRAM banks",                               "8" },
+                              { "row_size",      "Sets the size of a DRAM row in bytes",                        "2048" },
+                              { "tRCD",          "Sets the row activate to column command delay in cycles",     "14" },
+                              { "tCAS",          "Sets the column command to data delay in cycles",             "14" },
+                              { "tRP",           "Sets the row precharge delay in cycles",                      "14" },
+                              { "page_policy",   "Sets the row buffer policy: open or closed",                  "open" },
+                              { "bus_bytes",     "Sets the channel bandwidth in bytes per cycle",               "16" },
+                              { "sched_window",  "Sets the number of queued transactions the scheduler searches", "16" },
+                              { "ops_per_cycle", "Sets the maximum number of transactions to issue per cycle",  "2" }
+      )
+
+      SST_ELI_DOCUMENT_SUBCOMPONENT_SLOTS()
+
+      SST_ELI_DOCUMENT_PORTS()
+
+      SST_ELI_DOCUMENT_STATISTICS(
+        {"ReadBytes",    "Counts the number of bytes read",                              "bytes",  1},
+        {"WriteBytes",   "Counts the number of bytes written",                           "bytes",  1},
+        {"RowHits",      "Counts the transactions that found their row open",            "count",  1},
+        {"RowEmpty",     "Counts the transactions that found their bank precharged",     "count",  1},
+        {"RowConflicts", "Counts the transactions that had to close another row",        "count",  1},
+        {"ReadLatency",  "Cycles from the arrival of a read to the delivery of its data", "cycles", 1},
+        {"WriteLatency", "Cycles from the arrival of a write to its completion",         "cycles", 1},
+        {"BusBusy",      "Counts the cycles the channel spends transferring data",       "cycles", 1}
+      )
+
+      /// RevDRAMCtrl: constructor
+      RevDRAMCtrl( ComponentId_t id, Params& params );
+
+      /// RevDRAMCtrl: destructor
+      virtual ~RevDRAMCtrl();
+
+      /// RevDRAMCtrl: initialization function
+      void init(unsigned int phase) override { }
+
+      /// RevDRAMCtrl: setup function
+      void setup() override { }
+
+      /// RevDRAMCtrl: finish function; prints the row buffer and channel summary
+      void finish() override;
+
+      /// RevDRAMCtrl: clock tick function
+      virtual bool clockTick(Cycle_t cycle);
+
+      /// RevDRAMCtrl: determines if outstanding requests exist
+      bool outstandingRqsts() override;
+
+      /// RevDRAMCtrl: retrieve the number of queued and in-flight requests
+      uint64_t getNumPendingRqsts() override;
+
+      /// RevDRAMCtrl: there are no cache layers
+      unsigned getLineSize() override { return 0; }
+
+      /// RevDRAMCtrl: send a flush request; there is nothing to flush
+      bool sendFLUSHRequest(uint64_t Addr, uint64_t PAddr, uint32_t Size,
+                            bool Inv,
+                            StandardMem::Request::flags_t flags) override { return true; }
+
+      /// RevDRAMCtrl: send a read request
+      bool sendREADRequest(uint64_t Addr, uint64_t PAddr,
+                           uint32_t Size, void *target,
+                           StandardMem::Request::flags_t flags) override;
+
+      /// RevDRAMCtrl: send a write request
+      bool sendWRITERequest(uint64_t Addr, uint64_t PAddr,
+                            uint32_t Size, char *buffer,
+                            StandardMem::Request::flags_t flags = 0) override;
+
+      /// RevDRAMCtrl: send a readlock request; timed as a read
+      bool sendREADLOCKRequest(uint64_t Addr, uint64_t PAddr,
+                               uint32_t Size, void *target,
+                               StandardMem::Request::flags_t flags) override;
+
+      /// RevDRAMCtrl: send a writelock request; timed as a write
+      bool sendWRITELOCKRequest(uint64_t Addr, uint64_t PAddr,
+                                uint32_t Size, char *buffer,
+                                StandardMem::Request::flags_t flags) override;
+
+      /// RevDRAMCtrl: send an atomic read-modify-write request
+      bool sendAMORequest(uint64_t Addr, uint64_t PAddr,
+                          uint32_t Size, char *buffer, void *target,
+                          StandardMem::Request::flags_t flags) override;
+
+      /// RevDRAMCtrl: send a loadlink request; timed as a read
+      bool sendLOADLINKRequest(uint64_t Addr, uint64_t PAddr,
+                               uint32_t Size,
+                               StandardMem::Request::flags_t flags) override;
+
+      /// RevDRAMCtrl: send a storecond request; timed as a write
+      bool sendSTORECONDRequest(uint64_t Addr, uint64_t PAddr,
+                                uint32_t Size, char *buffer,
+                                StandardMem::Request::flags_t flags) override;
+
+      /// RevDRAMCtrl: custom requests are not supported
+      bool sendCUSTOMREADRequest(uint64_t Addr, uint64_t PAddr,
+                                 uint32_t Size, void *target,
+                                 unsigned Opc,
+                                 StandardMem::Request::flags_t flags) override;
+
+      /// RevDRAMCtrl: custom requests are not supported
+      bool sendCUSTOMWRITERequest(uint64_t Addr, uint64_t PAddr,
+                                  uint32_t Size, char *buffer,
+                                  unsigned Opc,
+                                  StandardMem::Request::flags_t flags) override;
+
+      /// RevDRAMCtrl: send a FENCE request
+      bool sendFENCE() override;
+
+      /// RevDRAMCtrl: StandardMem responses never arrive; fatal
+      void handleReadResp(StandardMem::ReadResp* ev) override;
+
+      /// RevDRAMCtrl: StandardMem responses never arrive; fatal
+      void handleWriteResp(StandardMem::WriteResp* ev) override;
+
+      /// RevDRAMCtrl: StandardMem responses never arrive; fatal
+      void handleFlushResp(StandardMem::FlushResp* ev) override;
+
+      /// RevDRAMCtrl: StandardMem responses never arrive; fatal
+      void handleCustomResp(StandardMem::CustomResp* ev) override;
+
+      /// RevDRAMCtrl: StandardMem responses never arrive; fatal
+      void handleInvResp(StandardMem::InvNotify* ev) override;
+
+      /// RevDRAMCtrl: handle RevMemCtrl flags for read responses
+      void handleFlagResp(RevMemOp *op) override;
+
+    private:
+      /// RevDRAMCtrl: statistics
+      typedef enum{
+        ReadBytes     = 0,
+        WriteBytes    = 1,
+        RowHits       = 2,
+        RowEmpty      = 3,
+        RowConflicts  = 4,
+        ReadLatency   = 5,
+        WriteLatency  = 6,
+        BusBusy       = 7
+      }DRAMCtrlStats;
+
+      /// RevDRAMCtrl: bank state
+      struct RevDRAMBank {
+        uint64_t OpenRow;                     ///< row held in the row buffer; _INVALID_ADDR_ if precharged
+        uint64_t Ready;                       ///< first cycle the bank accepts a command
+      };
+
+      /// RevDRAMCtrl: one DRAM transaction; a request that crosses a row is split
+      struct RevDRAMTxn {
+        RevMemOp *Op;                         ///< owning request; a FENCE op for fences
+        uint32_t Size;                        ///< bytes transferred
+        unsigned Bank;                        ///< target bank
+        uint64_t Row;                         ///< target row
+      };
+
+      /// RevDRAMCtrl: split an op into transactions and queue them
+      void enqueueRqst(RevMemOp *op);
+
+      /// RevDRAMCtrl: issue up to ops_per_cycle transactions
+      void schedule();
+
+      /// RevDRAMCtrl: start the target transaction and compute when it completes
+      void issueTxn(RevDRAMTxn &T);
+
+      /// RevDRAMCtrl: deliver the data of a request whose transactions have all completed
+      void completeRqst(RevMemOp *op);
+
+      /// RevDRAMCtrl: retrieve the backing page that holds Addr, allocating it on first touch
+      uint8_t *getPage(uint64_t Addr);
+
+      /// RevDRAMCtrl: copy Size bytes at Addr out of the backing store
+      void readBacking(uint64_t Addr, uint32_t Size, uint8_t *Data);
+
+      /// RevDRAMCtrl: copy Size bytes into the backing store at Addr
+      void writeBacking(uint64_t Addr, uint32_t Size, const uint8_t *Data);
+
+      /// RevDRAMCtrl: re-register the clock handler after the controller went idle
+      void wakeClock();
+
+      /// RevDRAMCtrl: inject statistics data for the target metric
+      void recordStat(DRAMCtrlStats Stat, uint64_t Data){ stats[Stat]->addData(Data); }
+
+      // -- private data members
+      unsigned numBanks;                      ///< number of banks
+      unsigned rowSize;                       ///< bytes per row
+      unsigned tRCD;                          ///< activate to column command delay
+      unsigned tCAS;                          ///< column command to data delay
+      unsigned tRP;                           ///< precharge delay
+      bool openPage;                          ///< rows stay open after an access
+      unsigned busBytes;                      ///< bytes moved across the channel per cycle
+      unsigned schedWindow;                   ///< queued transactions searched by the scheduler
+      unsigned maxOps;                        ///< transactions issued per cycle
+
+      uint64_t curCycle;                      ///< current controller cycle
+      uint64_t busFree;                       ///< first cycle the channel is free
+      TimeConverter* timeConverter;           ///< controller clock
+      Clock::Handler<RevDRAMCtrl>* clockHandler; ///< controller clock handler
+      bool clockActive;                       ///< the clock handler is registered
+
+      std::vector<RevDRAMBank> banks;         ///< bank state
+      std::deque<RevDRAMTxn> rqstQ;           ///< queued transactions and fences, oldest first
+      std::multimap<uint64_t,RevMemOp *> inflight; ///< issued transactions keyed by completion cycle
+      uint64_t numRqsts;                      ///< number of requests queued or in flight
+      uint64_t numRowHits;                    ///< transactions that found their row open
+      uint64_t numRowEmpty;                   ///< transactions that found their bank precharged
+      uint64_t numRowConflicts;               ///< transactions that had to close another row
+      uint64_t busCycles;                     ///< cycles the channel spent transferring data
+      std::unordered_map<uint64_t,std::vector<uint8_t>> backing; ///< sparse backing store; page address -> data
+
+      std::vector<Statistic<uint64_t>*> stats; ///< statistics vector
+    }; // class RevDRAMCtrl
+  } // namespace RevCPU
+} // namespace SST
+
+#endif // _SST_REVCPU_REVDRAMCTRL_H_
+
+// EOF
@@ -0,0 +1,183 @@
+//
+// _RevDataPrefetcher_h_
+//
+// Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+//
+// See LICENSE in the top level directory for licensing details
+//
+
+#ifndef _SST_REVCPU_REVDATAPREFETCHER_H_
+#define _SST_REVCPU_REVDATAPREFETCHER_H_
+
+// -- C++ Headers
+#include <cstdint>
+#include <vector>
+
+// -- SST Headers
+#include <sst/core/sst_config.h>
+#include <sst/core/output.h>
+#include <sst/core/subcomponent.h>
+
+#ifndef _INVALID_ADDR_
+#define _INVALID_ADDR_ 0xFFFFFFFFFFFFFFFF
+#endif
+
+/// RevDataPrefetcher: prefetches never leave the aligned region of this size that holds the trigger
+#define _REV_PF_REGION_ 4096
+
+namespace SST {
+  namespace RevCPU {
+
+    // ----------------------------------------
+    // RevDataPrefetcher
+    // ----------------------------------------
+    // Data prefetcher API for RevBasicMemCtrl.  The controller reports
+    // each cacheable demand read and the prefetcher answers with the
+    // line addresses it would like fetched; the controller owns issue,
+    // de-duplication and the usefulness statistics.
+    class RevDataPrefetcher : public SST::SubComponent {
+    public:
+      SST_ELI_REGISTER_SUBCOMPONENT_API(SST::RevCPU::RevDataPrefetcher)
+
+      SST_ELI_DOCUMENT_PARAMS({ "verbose", "Set the verbosity of output for the prefetcher", "0" },
+                              { "degree",  "Sets the number of lines requested per trigger",  "2" }
+      )
+
+      /// RevDataPrefetcher: constructor
+      RevDataPrefetcher( ComponentId_t id, Params& params );
+
+      /// RevDataPrefetcher: destructor
+      virtual ~RevDataPrefetcher();
+
+      /// RevDataPrefetcher: observe a demand read; append the line addresses to prefetch to Lines
+      virtual void observe( uint64_t Addr, uint64_t PC, unsigned LineSize,
+                            std::vector<uint64_t> &Lines ) = 0;
+
+    protected:
+      SST::Output *output;                    ///< RevDataPrefetcher: output handler
+      unsigned degree;                        ///< RevDataPrefetcher: lines requested per trigger
+
+      /// RevDataPrefetcher: append Line if it stays within the region of Trigger
+      void propose( uint64_t Trigger, uint64_t Line, std::vector<uint64_t> &Lines ){
+        if( (Line / _REV_PF_REGION_) == (Trigger / _REV_PF_REGION_) )
+          Lines.push_back(Line);
+      }
+    }; // class RevDataPrefetcher
+
+    // ----------------------------------------
+    // RevNextLinePrefetcher
+    // ----------------------------------------
+    // Requests the next degree lines whenever a demand read moves to
+    // a new line.
+    class RevNextLinePrefetcher : public RevDataPrefetcher {
+    public:
+      SST_ELI_REGISTER_SUBCOMPONENT_DERIVED(RevNextLinePrefetcher, "revcpu",
+                                            "RevNextLinePrefetcher",
+                                            SST_ELI_ELEMENT_VERSION(1, 0, 0),
+                                            "RISC-V Rev next-line data prefetcher",
+                                            SST::RevCPU::RevDataPrefetcher
+                                           )
+
+      SST_ELI_DOCUMENT_PARAMS({ "verbose", "Set the verbosity of output for the prefetcher", "0" },
+                              { "degree",  "Sets the number of lines requested per trigger",  "2" }
+      )
+
+      /// RevNextLinePrefetcher: constructor
+      RevNextLinePrefetcher( ComponentId_t id, Params& params );
+
+      /// RevNextLinePrefetcher: observe a demand read
+      void observe( uint64_t Addr, uint64_t PC, unsigned LineSize,
+                    std::vector<uint64_t> &Lines ) override;
+
+    private:
+      uint64_t lastLine;                      ///< RevNextLinePrefetcher: line of the previous demand read
+    }; // class RevNextLinePrefetcher
+
+    // ----------------------------------------
+    // RevStridePrefetcher
+    // ----------------------------------------
+    // Per-PC reference prediction table.  Once a load has repeated the
+    // same stride twice, the next degree strides ahead are requested.
+    class RevStridePrefetcher : public RevDataPrefetcher {
+    public:
+      SST_ELI_REGISTER_SUBCOMPONENT_DERIVED(RevStridePrefetcher, "revcpu",
+                                            "RevStridePrefetcher",
+                                            SST_ELI_ELEMENT_VERSION(1, 0, 0),
+                                            "RISC-V Rev per-PC stride data prefetcher",
+                                            SST::RevCPU::RevDataPrefetcher
+                                           )
+
+      SST_ELI_DOCUMENT_PARAMS({ "verbose",    "Set the verbosity of output for the prefetcher",   "0" },
+                              { "degree",     "Sets the number of lines requested per trigger",    "2" },
+                              { "table_size", "Sets the number of entries in the PC stride table", "64" }
+      )
+
+      /// RevStridePrefetcher: constructor
+      RevStridePrefetcher( ComponentId_t id, Params& params );
+
+      /// RevStridePrefetcher: observe a demand read
+      void observe( uint64_t Addr, uint64_t PC, unsigned LineSize,
+                    std::vector<uint64_t> &Lines ) override;
+
+    private:
+      /// RevStridePrefetcher: stride table entry
+      struct RevStrideEntry {
+        uint64_t PC;                          ///< tag
+        uint64_t LastAddr;                    ///< address of the previous read by this PC
+        int64_t Stride;                       ///< last observed stride
+        unsigned Confidence;                  ///< number of consecutive repeats of Stride
+      };
+
+      std::vector<RevStrideEntry> table;      ///< RevStridePrefetcher: direct mapped stride table
+    }; // class RevStridePrefetcher
+
+    // ----------------------------------------
+    // RevStreamPrefetcher
+    // ----------------------------------------
+    // Tracks a small set of ascending or descending line streams
+    // regardless of the issuing PC and runs degree lines ahead of
+    // each confirmed stream.
+    class RevStreamPrefetcher : public RevDataPrefetcher {
+    public:
+      SST_ELI_REGISTER_SUBCOMPONENT_DERIVED(RevStreamPrefetcher, "revcpu",
+                                            "RevStreamPrefetcher",
+                                            SST_ELI_ELEMENT_VERSION(1, 0, 0),
+                                            "RISC-V Rev stream data prefetcher",
+                                            SST::RevCPU::RevDataPrefetcher
+                                           )
+
+      SST_ELI_DOCUMENT_PARAMS({ "verbose", "Set the verbosity of output for the prefetcher",        "0" },
+                              { "degree",  "Sets the number of lines requested per trigger",         "2" },
+                              { "streams", "Sets the number of streams tracked",                     "8" },
+                              { "window",  "Sets the distance in lines that continues a stream",     "4" }
+      )
+
+      /// RevStreamPrefetcher: constructor
+      RevStreamPrefetcher( ComponentId_t id, Params& params );
+
+      /// RevStreamPrefetcher: observe a demand read
+      void observe( uint64_t Addr, uint64_t PC, unsigned LineSize,
+                    std::vector<uint64_t> &Lines ) override;
+
+    private:
+      /// RevStreamPrefetcher: stream entry
+      struct RevStreamEntry {
+        uint64_t LastLine;                    ///< most recent line number in the stream
+        int Dir;                              ///< +1 ascending, -1 descending, 0 unknown
+        unsigned Confidence;                  ///< number of accesses that agreed with Dir
+        uint64_t LRU;                         ///< time of the last access
+        bool Valid;                           ///< the entry tracks a stream
+      };
+
+      std::vector<RevStreamEntry> streams;    ///< RevStreamPrefetcher: stream table
+      unsigned window;                        ///< RevStreamPrefetcher: lines that continue a stream
+      uint64_t now;                           ///< RevStreamPrefetcher: access counter for LRU
+    }; // class RevStreamPrefetcher
+  } // namespace RevCPU
+} // namespace SST
+
+#endif // _SST_REVCPU_REVDATAPREFETCHER_H_
+
+// EOF
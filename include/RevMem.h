@@ -14,12 +14,15 @@
 // -- C++ Headers
 #include <ctime>
 #include <vector>
+#include <unordered_set>
+#include <unordered_map>
 #include <algorithm>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <random>
 #include <mutex>
+#include <cstring>
 
 // -- SST Headers
 #include <sst/core/sst_config.h>
@@ -29,11 +32,32 @@
 // -- RevCPU Headers
 #include "RevOpts.h"
 #include "RevMemCtrl.h"
+#include "RevTLB.h"
+#include "RevPageTable.h"
+#include "RevCache.h"
+#include "RevMemTrace.h"
+#include "RevCheckpoint.h"
 
 #ifndef _REVMEM_BASE_
 #define _REVMEM_BASE_ 0x00000000
 #endif
 
+#ifndef _REVMEM_PT_BITS_
+#define _REVMEM_PT_BITS_ 9
+#endif
+
+#ifndef _REVMEM_LRSC_GRANULE_
+#define _REVMEM_LRSC_GRANULE_ 64
+#endif
+
+#ifndef _REVMEM_HOSTTLB_ENTRIES_
+#define _REVMEM_HOSTTLB_ENTRIES_ 256
+#endif
+
+#ifndef _REVMEM_CACHE_LEVELS_
+#define _REVMEM_CACHE_LEVELS_ 2
+#endif
+
 #define REVMEM_FLAGS(x) ((StandardMem::Request::flags_t)(x))
 
 #define _INVALID_ADDR_ 0xFFFFFFFFFFFFFFFF
@@ -100,6 +124,13 @@ namespace SST {
       template <typename T>
       bool ReadVal( uint64_t Addr, T *Target,
                     StandardMem::Request::flags_t flags){
+        // naturally aligned scalars never cross a page; serve them with a single host load
+        if( !ctrl && (sizeof(T) <= 8) && ((Addr & (sizeof(T)-1)) == 0) ){
+          std::memcpy(Target, HostAddr(Addr), sizeof(T));
+          memStats.bytesRead += sizeof(T);
+          NoteAccess(Addr, sizeof(T), RevTraceOp::READ, (uint32_t)(flags));
+          return true;
+        }
         return ReadMem(Addr, sizeof(T), (void *)(Target), flags);
       }
 
@@ -130,6 +161,24 @@ namespace SST {
       // ----------------------------------------------------
       // ---- Write Memory Interfaces
       // ----------------------------------------------------
+      /// RevMem: template write memory interface
+      template <typename T>
+      bool WriteVal( uint64_t Addr, T Value,
+                     StandardMem::Request::flags_t flags){
+        // naturally aligned scalars never cross a page; serve them with a single host store
+        if( !ctrl && (sizeof(T) <= 8) && ((Addr & (sizeof(T)-1)) == 0) &&
+            (Addr != 0xDEADBEEF) ){
+          if( !FutureRes.empty() )
+            RevokeFuture(Addr);
+          InvalidateLRSC(Addr, sizeof(T));
+          std::memcpy(HostAddr(Addr), &Value, sizeof(T));
+          memStats.bytesWritten += sizeof(T);
+          NoteAccess(Addr, sizeof(T), RevTraceOp::WRITE, (uint32_t)(flags));
+          return true;
+        }
+        return WriteMem(Addr, sizeof(T), (void *)(&Value), flags);
+      }
+
       /// RevMem: Write a uint8 to the target memory location
       void WriteU8( uint64_t Addr, uint8_t Value );
 
@@ -151,12 +200,29 @@ namespace SST {
       // ----------------------------------------------------
       // ---- Atomic/Future/LRSC Interfaces
       // ----------------------------------------------------
+      /// RevMem: Atomic read-modify-write; the prior memory value is returned in Target
+      bool AMOMem( uint64_t Addr, size_t Len, void *Data, void *Target,
+                   StandardMem::Request::flags_t flags );
+
+      /// RevMem: template atomic read-modify-write interface
+      template <typename T>
+      bool AMOVal( uint64_t Addr, T *Data, T *Target,
+                   StandardMem::Request::flags_t flags ){
+        return AMOMem(Addr, sizeof(T), (void *)(Data), (void *)(Target), flags);
+      }
+
       /// RevMem: Add a memory reservation for the target address
       bool LR(unsigned Hart, uint64_t Addr);
 
-      /// RevMem: Clear a memory reservation for the target address
+      /// RevMem: Clear a memory reservation for the target address; returns true if the reservation was held
       bool SC(unsigned Hart, uint64_t Addr);
 
+      /// RevMem: Retrieve the number of store conditional attempts for the target hart
+      uint64_t GetSCAttempts(unsigned Hart){ return Hart < SCAttempts.size() ? SCAttempts[Hart] : 0; }
+
+      /// RevMem: Retrieve the number of failed store conditionals for the target hart
+      uint64_t GetSCFailures(unsigned Hart){ return Hart < SCFailures.size() ? SCFailures[Hart] : 0; }
+
       /// RevMem: Initiates a future operation [RV64P only]
       bool SetFuture( uint64_t Addr );
 
@@ -169,11 +235,99 @@ namespace SST {
       /// RevMem: Randomly assign a memory cost
       unsigned RandCost( unsigned Min, unsigned Max );
 
+      /// RevMem: Retrieve the cost of the most recent access; Min:Max is charged when it reaches memory
+      unsigned AccessCost( unsigned Min, unsigned Max ){
+        if( lastRegion )
+          return lastLatency + RandCost(lastRegion->Region.MinCost, lastRegion->Region.MaxCost);
+        if( !cacheModel )
+          return RandCost(Min, Max);
+        return lastLatency + (lastMiss ? RandCost(Min, Max) : 0);
+      }
+
+      /// RevMem: Add an address range with its own latency and bandwidth
+      void AddMemRegion(const RevMemRegion &Region);
+
+      /// RevMem: Set the current cycle; used to pace bandwidth-limited regions
+      void SetCycle(uint64_t Cycle){ curCycle = Cycle; }
+
+      /// RevMem: Set the hart and PC of the instruction issuing the next accesses
+      void SetActiveHart(unsigned Hart, uint64_t PC){
+        activeHart = Hart;
+        activePC = PC;
+        if( ctrl )
+          ctrl->setActivePC(PC);
+      }
+
+      /// RevMem: Attach a memory access trace; the caller retains ownership
+      void SetTrace(RevMemTrace *Trace){ trace = Trace; }
+
+      /// RevMem: Write the touched pages and the memory state to a checkpoint
+      void Checkpoint(RevCheckpoint &C);
+
+      /// RevMem: Restore the touched pages and the memory state from a checkpoint; pages are mapped from the file
+      void Restore(RevCheckpoint &C);
+
+      /// RevMem: Enable the per-page heat map; TopN hot pages are listed in every dump
+      void EnableHeatMap(const std::string &File, unsigned TopN);
+
+      /// RevMem: Write the working-set and hot-page statistics for the interval ending at the current cycle
+      void DumpHeatMap(bool Final);
+
+      /// RevMem: Enable the cache timing model; an L2 Size of 0 models a single level
+      void EnableCacheModel(const RevCacheConfig &L1, const RevCacheConfig &L2);
+
+      /// RevMem: Retrieve the number of cache hits at the target level for the target core
+      uint64_t GetCacheHits(unsigned Level, unsigned Core){
+        return (Level < _REVMEM_CACHE_LEVELS_ && Core < CacheHits[Level].size()) ? CacheHits[Level][Core] : 0;
+      }
+
+      /// RevMem: Retrieve the number of cache misses at the target level for the target core
+      uint64_t GetCacheMisses(unsigned Level, unsigned Core){
+        return (Level < _REVMEM_CACHE_LEVELS_ && Core < CacheMisses[Level].size()) ? CacheMisses[Level][Core] : 0;
+      }
+
+      /// RevMem: Retrieve the number of region accesses for the target core
+      uint64_t GetRegionAccesses(unsigned Core){
+        return Core < RegionAccesses.size() ? RegionAccesses[Core] : 0;
+      }
+
+      /// RevMem: Retrieve the cycles the target core waited on region bandwidth
+      uint64_t GetRegionStalls(unsigned Core){
+        return Core < RegionStalls.size() ? RegionStalls[Core] : 0;
+      }
+
       /// RevMem: Used to access & incremenet the global software PID counter
       uint32_t GetNewThreadPID();
 
-      /// RevMem: Used to set the size of the TLBSize
-      void SetTLBSize(unsigned numEntries){ tlbSize = numEntries; }
+      /// RevMem: Used to set the size and associativity of each per-core TLB
+      void SetTLBSize(unsigned numEntries, unsigned numWays);
+
+      /// RevMem: Used to set the page size; must be called prior to the first memory access
+      void SetPageSize(uint64_t PageSize);
+
+      /// RevMem: Request transparent huge pages for the internal backing memory
+      void EnableHugePages();
+
+      /// RevMem: Retrieve the page size
+      uint64_t GetPageSize() { return pageSize; }
+
+      /// RevMem: Set the core issuing subsequent memory requests
+      void SetActiveCore(unsigned Core){
+        activeCore = Core;
+        activeTLB = TLBs[Core];
+        if( ctrl )
+          ctrl->setActiveCore(Core);
+        activeHostTLB = &HostTLB[Core * _REVMEM_HOSTTLB_ENTRIES_];
+      }
+
+      /// RevMem: Report whether the target core's front end is stalled waiting on instruction fetch
+      void SetFetchStall(unsigned Core, bool Stalled){
+        if( ctrl )
+          ctrl->setFetchStall(Core, Stalled);
+      }
+
+      /// RevMem: Retrieve the TLB for the target core
+      RevTLB *GetTLB(unsigned Core){ return TLBs[Core]; }
   
       ///< RevMem: default memory size allocated to new threads (Unimplemented)
       uint64_t DefaultThreadMemSize = 4*1024*1024;    
@@ -182,12 +336,20 @@ namespace SST {
     public:
       uint64_t TLBHits;
       uint64_t TLBMisses;
-      uint32_t floatsRead;
-      uint32_t floatsWritten;
-      uint32_t doublesWritten;
-      uint32_t doublesRead;
-      uint32_t bytesRead;
-      uint32_t bytesWritten;
+      uint64_t SCAttempts;
+      uint64_t SCFailures;
+      uint64_t L1Hits;
+      uint64_t L1Misses;
+      uint64_t L2Hits;
+      uint64_t L2Misses;
+      uint64_t RegionAccesses;
+      uint64_t RegionStalls;
+      uint64_t floatsRead;
+      uint64_t floatsWritten;
+      uint64_t doublesWritten;
+      uint64_t doublesRead;
+      uint64_t bytesRead;
+      uint64_t bytesWritten;
     };
 
     RevMemStats memStats;
@@ -196,34 +358,137 @@ namespace SST {
       char *physMem;                          ///< RevMem: memory container
 
     private:
-      std::unordered_map<uint64_t, std::pair<uint64_t, std::list<uint64_t>::iterator>> TLB;
-      std::list<uint64_t> LRUQueue; ///< RevMem: List ordered by last access for implementing LRU policy when TLB fills up
+      /// RevMem: host-side translation cache entry
+      struct RevHostTLBEntry {
+        uint64_t VPN;               ///< RevHostTLBEntry: virtual page number
+        char *Host;                 ///< RevHostTLBEntry: host address of the page
+        unsigned Slot;              ///< RevHostTLBEntry: modelled TLB slot holding the page
+      };
+
+      std::vector<RevTLB *> TLBs;   ///< RevMem: per-core TLBs
+      unsigned activeCore;          ///< RevMem: core issuing the current request
+      RevTLB *activeTLB;            ///< RevMem: TLB of the core issuing the current request
+      std::vector<RevHostTLBEntry> HostTLB; ///< RevMem: per-core direct-mapped virtual page to host pointer cache
+      RevHostTLBEntry *activeHostTLB;       ///< RevMem: host translation cache of the core issuing the current request
       unsigned long memSize;        ///< RevMem: size of the target memory
-      unsigned tlbSize;             ///< RevMem: size of the target memory
       RevOpts *opts;                ///< RevMem: options object
       RevMemCtrl *ctrl;             ///< RevMem: memory controller object
       SST::Output *output;          ///< RevMem: output handler
 
-      uint64_t SearchTLB(uint64_t vAddr);                       ///< RevMem: Used to check the TLB for an entry
-      void AddToTLB(uint64_t vAddr, uint64_t physAddr);         ///< RevMem: Used to add a new entry to TLB & LRUQueue
-      void FlushTLB();                                          ///< RevMem: Used to flush the TLB & LRUQueue
+      void FlushTLB();                                          ///< RevMem: Used to flush every per-core TLB
       uint64_t CalcPhysAddr(uint64_t pageNum, uint64_t vAddr);  ///< RevMem: Used to calculate the physical address based on virtual address
 
+      /// RevMem: Translate a virtual address to a host pointer into the internal memory
+      char *HostAddr(uint64_t vAddr){
+        const uint64_t VPN = vAddr >> addrShift;
+        RevHostTLBEntry &E = activeHostTLB[VPN & (_REVMEM_HOSTTLB_ENTRIES_ - 1)];
+        if( E.VPN == VPN ){
+          // entries are dropped when the modelled TLB evicts the page, so this is a
+          // TLB hit; it also refreshes the page in the PLRU state of its set
+          activeTLB->RecordHit(E.Slot);
+          memStats.TLBHits++;
+          return E.Host + (vAddr & (pageSize - 1));
+        }
+        return &physMem[CalcPhysAddr(VPN, vAddr)];
+      }
+
       std::mutex pid_mtx;         ///< RevMem: Used for incrementing ThreadCtx PID counter
       uint32_t PIDCount = 1023;   ///< RevMem: Monotonically increasing PID counter for assigning new PIDs without conflicts
 
       //c++11 should guarentee that these are all zero-initializaed
-      std::map<uint64_t, std::pair<uint32_t, bool>> pageMap;   ///< RevMem: map of logical to pair<physical addresses, allocated>
-      uint32_t                                      pageSize;  ///< RevMem: size of allocated pages
-      uint32_t                                      addrShift; ///< RevMem: Bits to shift to caclulate page of address 
-      uint32_t                                      nextPage;  ///< RevMem: next physical page to be allocated. Will result in index 
+      RevPageTable                                 *pageTable; ///< RevMem: radix page table of logical to physical pages
+      uint64_t                                      pageSize;  ///< RevMem: size of allocated pages
+      unsigned                                      addrShift; ///< RevMem: Bits to shift to caclulate page of address 
+      uint64_t                                      nextPage;  ///< RevMem: next physical page to be allocated. Will result in index 
                                                                     /// nextPage * pageSize into physMem
 
       uint64_t stacktop;        ///< RevMem: top of the stack
 
-      std::vector<uint64_t> FutureRes;  ///< RevMem: future operation reservations
+      std::unordered_set<uint64_t> FutureRes;  ///< RevMem: future operation reservations
+
+      std::vector<uint64_t> LRSC;                       ///< RevMem: reserved granule per hart; _INVALID_ADDR_ when none is held
+      std::unordered_map<uint64_t, unsigned> LRSCLines; ///< RevMem: number of harts holding each reserved granule
+      std::vector<uint64_t> SCAttempts;                 ///< RevMem: store conditional attempts per hart
+      std::vector<uint64_t> SCFailures;                 ///< RevMem: failed store conditionals per hart
+
+      std::vector<RevCache *> Caches[_REVMEM_CACHE_LEVELS_];       ///< RevMem: cache model per level; one entry when the level is shared
+      std::vector<uint64_t> CacheHits[_REVMEM_CACHE_LEVELS_];      ///< RevMem: cache hits per level per core
+      std::vector<uint64_t> CacheMisses[_REVMEM_CACHE_LEVELS_];    ///< RevMem: cache misses per level per core
+      bool cacheModel = false;      ///< RevMem: the cache timing model is enabled
+      unsigned lastLatency = 0;     ///< RevMem: cache latency of the most recent access
+      bool lastMiss = false;        ///< RevMem: the most recent access missed every cache level
+
+      /// RevMem: Probe the cache model with an access and record its latency
+      void CacheAccess(uint64_t Addr, uint64_t Len);
+
+      /// RevMem: region-specific latency along with its bandwidth occupancy
+      struct RevRegionState {
+        RevMemRegion Region;        ///< RevRegionState: region configuration
+        uint64_t BusyUntil;         ///< RevRegionState: cycle at which the region can accept another transfer
+      };
+
+      std::vector<RevRegionState> Regions;  ///< RevMem: region table sorted by base address
+      RevRegionState *lastRegion = nullptr; ///< RevMem: slowest region hit by the most recent access
+      std::vector<uint64_t> RegionAccesses; ///< RevMem: region accesses per core
+      std::vector<uint64_t> RegionStalls;   ///< RevMem: cycles spent waiting on region bandwidth per core
+      uint64_t curCycle = 0;                ///< RevMem: current cycle of the issuing core
+
+      RevMemTrace *trace = nullptr;         ///< RevMem: memory access trace; nullptr when disabled
+      unsigned activeHart = 0;              ///< RevMem: hart issuing the current request
+      uint64_t activePC = 0;                ///< RevMem: PC of the instruction issuing the current request
+
+      /// RevMem: Emit a trace record for an access
+      void TraceAccess(uint64_t Addr, uint64_t Len, RevTraceOp Op, uint32_t Flags);
+
+      FILE *heatFile = nullptr;             ///< RevMem: heat map output; nullptr when disabled
+      unsigned heatTop = 0;                 ///< RevMem: number of hot pages listed per heat map dump
+      uint64_t heatEpoch = 0;               ///< RevMem: first cycle of the current heat map interval
+
+      /// RevMem: Update the heat map counters of every page touched by an access
+      void HeatAccess(uint64_t Addr, uint64_t Len, RevTraceOp Op){
+        const uint64_t Last = (Addr + (Len ? Len-1 : 0)) >> addrShift;
+        for( uint64_t VPN = Addr >> addrShift; VPN <= Last; VPN++ ){
+          RevPTE *PTE = pageTable->Find(VPN);
+          if( !PTE || !(PTE->Flags & PTE_VALID) )
+            continue;
+          if( (PTE->Reads | PTE->Writes) == 0 )
+            PTE->FirstTouch = curCycle;
+          PTE->LastTouch = curCycle;
+          PTE->Reads += (Op != RevTraceOp::WRITE);
+          PTE->Writes += (Op != RevTraceOp::READ);
+          PTE->Interval++;
+          PTE->Cores |= (1ull << (activeCore & 63));
+        }
+      }
+
+      /// RevMem: Record an access for tracing and timing purposes
+      void NoteAccess(uint64_t Addr, uint64_t Len, RevTraceOp Op, uint32_t Flags){
+        if( trace )
+          TraceAccess(Addr, Len, Op, Flags);
+        if( heatFile )
+          HeatAccess(Addr, Len, Op);
+        if( !Regions.empty() && RegionAccess(Addr, Len) )
+          return;
+        // instruction fetches would evict data lines; only data accesses are modelled
+        if( cacheModel && !(Flags & (uint32_t)(RevFlag::F_IFETCH)) )
+          CacheAccess(Addr, Len);
+      }
+
+      /// RevMem: Charge each region the access overlaps for its share of the bytes; false if none
+      bool RegionAccess(uint64_t Addr, uint64_t Len);
+
+      /// RevMem: Drop the reservation held by the target hart
+      void ClearLRSC(unsigned Hart);
+
+      /// RevMem: Invalidate other harts' reservations overlapping a write
+      void InvalidateLRSC(uint64_t Addr, uint64_t Len){
+        if( LRSCLines.empty() )
+          return;
+        InvalidateLRSCLines(Addr, Len);
+      }
 
-      std::vector<std::pair<unsigned,uint64_t>> LRSC;   ///< RevMem: load reserve/store conditional vector
+      /// RevMem: Invalidate other harts' reservations overlapping a write when any are held
+      void InvalidateLRSCLines(uint64_t Addr, uint64_t Len);
 
     }; // class RevMem
   } // namespace RevCPU
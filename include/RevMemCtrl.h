@@ -15,11 +15,14 @@
 #include <ctime>
 #include <vector>
 #include <list>
+#include <deque>
+#include <unordered_map>
 #include <algorithm>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <random>
+#include <type_traits>
 
 // -- SST Headers
 #include <sst/core/sst_config.h>
@@ -29,6 +32,7 @@
 
 // -- RevCPU Headers
 #include "RevOpts.h"
+#include "RevDataPrefetcher.h"
 
 // RV{32,64} Register Operation Macros
                     //(r) = ((r) & (~r));
@@ -78,9 +82,57 @@ namespace SST {
       F_SEXT32 = 1 << 17,     /// sign extend the 32bit result
       F_SEXT64 = 1 << 18,     /// sign extend the 64bit result
       F_ZEXT32 = 1 << 19,     /// zero extend the 32bit result
-      F_ZEXT64 = 1 << 20      /// zero extend the 64bit result
+      F_ZEXT64 = 1 << 20,     /// zero extend the 64bit result
+      F_AMOADD = 1 << 21,     /// AMO add
+      F_AMOXOR = 1 << 22,     /// AMO xor
+      F_AMOAND = 1 << 23,     /// AMO and
+      F_AMOOR  = 1 << 24,     /// AMO or
+      F_AMOMIN = 1 << 25,     /// AMO signed minimum
+      F_AMOMAX = 1 << 26,     /// AMO signed maximum
+      F_AMOMINU = 1 << 27,    /// AMO unsigned minimum
+      F_AMOMAXU = 1 << 28,    /// AMO unsigned maximum
+      F_AMOSWAP = 1 << 29,    /// AMO swap
+      F_IFETCH = 1 << 30      /// instruction fetch
     };
 
+    /// RevFlag: mask of every AMO operation flag
+    #define _REV_AMO_FLAGS_ ((uint32_t)(0x1FF) << 21)
+
+    /// RevBasicMemCtrl: number of op classes with queueing delay and latency statistics; READ through CUSTOM
+    #define _REV_LAT_CLASSES_ 8
+
+    /// RevBasicMemCtrl: number of prefetched lines tracked for the usefulness statistics
+    #define _REV_PF_TRACK_ 256
+
+    /// RevMemOp: payload bytes stored inline in the op; larger payloads use the heap
+    #define _REV_MEMOP_INLINE_ 64
+
+    /// RevAMOCompute: derive the value an AMO stores given the current memory value
+    template <typename T>
+    T RevAMOCompute( T Old, T Val, StandardMem::Request::flags_t flags ){
+      typedef typename std::make_signed<T>::type S;
+      const uint32_t F = (uint32_t)(flags);
+      if( F & (uint32_t)(RevFlag::F_AMOADD) )
+        return Old + Val;
+      else if( F & (uint32_t)(RevFlag::F_AMOXOR) )
+        return Old ^ Val;
+      else if( F & (uint32_t)(RevFlag::F_AMOAND) )
+        return Old & Val;
+      else if( F & (uint32_t)(RevFlag::F_AMOOR) )
+        return Old | Val;
+      else if( F & (uint32_t)(RevFlag::F_AMOMIN) )
+        return ((S)(Old) < (S)(Val)) ? Old : Val;
+      else if( F & (uint32_t)(RevFlag::F_AMOMAX) )
+        return ((S)(Old) > (S)(Val)) ? Old : Val;
+      else if( F & (uint32_t)(RevFlag::F_AMOMINU) )
+        return (Old < Val) ? Old : Val;
+      else if( F & (uint32_t)(RevFlag::F_AMOMAXU) )
+        return (Old > Val) ? Old : Val;
+      else if( F & (uint32_t)(RevFlag::F_AMOSWAP) )
+        return Val;
+      return Old;
+    }
+
     // ----------------------------------------
     // RevMemOp
     // ----------------------------------------
@@ -110,6 +162,11 @@ namespace SST {
       RevMemOp( uint64_t Addr, uint64_t PAddr, uint32_t Size, char *buffer,
                 RevMemOp::MemOp Op, StandardMem::Request::flags_t flags );
 
+      /// RevMemOp overloaded constructor
+      RevMemOp( uint64_t Addr, uint64_t PAddr, uint32_t Size, char *buffer,
+                void *target, RevMemOp::MemOp Op,
+                StandardMem::Request::flags_t flags );
+
       /// RevMemOp overloaded constructor
       RevMemOp( uint64_t Addr, uint64_t PAddr, uint32_t Size, void *target,
                 unsigned CustomOpc, RevMemOp::MemOp Op,
@@ -123,9 +180,18 @@ namespace SST {
       /// RevMemOp destructor
       ~RevMemOp();
 
+      /// RevMemOp: allocate an op, recycling storage from the free list when possible
+      static void *operator new(size_t Sz);
+
+      /// RevMemOp: release an op's storage to the free list
+      static void operator delete(void *P, size_t Sz);
+
       /// RevMemOp: retrieve the memory operation type
       MemOp getOp() { return Op; }
 
+      /// RevMemOp: set the memory operation type
+      void setOp(MemOp O) { Op = O; }
+
       /// RevMemOp: retrieve the custom opcode
       unsigned getCustomOpc() { return CustomOpc; }
 
@@ -138,8 +204,11 @@ namespace SST {
       /// RevMemOp: retrieve the size of the request
       uint32_t getSize() { return Size; }
 
-      /// RevMemOp: retrieve the memory buffer
-      std::vector<uint8_t> getBuf() { return membuf; }
+      /// RevMemOp: retrieve the memory buffer; only valid for ops built with a buffer
+      const uint8_t *getBuf() { return (Size <= _REV_MEMOP_INLINE_) ? inlineBuf : membuf.data(); }
+
+      /// RevMemOp: retrieve a copy of the memory buffer in the form StandardMem expects
+      std::vector<uint8_t> getBufVector() { return std::vector<uint8_t>(getBuf(), getBuf() + Size); }
 
       /// RevMemOp: retrieve the memory operation flags
       StandardMem::Request::flags_t getFlags() { return flags; }
@@ -151,7 +220,10 @@ namespace SST {
       StandardMem::Request::flags_t getNonCacheFlags() { return ((uint32_t)(flags) & 0b1111111111111101); }
 
       /// RevMemOp: sets the number of split cache line requests
-      void setSplitRqst(unsigned S){ SplitRqst = S; }
+      void setSplitRqst(unsigned S){ SplitRqst = S; SplitLeft = S; }
+
+      /// RevMemOp: retire one split cache line request; returns the number still in flight
+      unsigned retireSplitRqst(){ return --SplitLeft; }
 
       /// RevMemOp: set the invalidate flag
       void setInv(bool I){ Inv = I; }
@@ -165,9 +237,33 @@ namespace SST {
       /// RevMemOp: retrieve the target address
       void *getTarget() { return target; }
 
+      /// RevMemOp: set the issuing core
+      void setCore(unsigned C) { Core = C; }
+
+      /// RevMemOp: retrieve the issuing core
+      unsigned getCore() { return Core; }
+
+      /// RevMemOp: set the cycle the op entered the request queue
+      void setEnqueueCycle(uint64_t C) { EnqueueCycle = C; }
+
+      /// RevMemOp: retrieve the cycle the op entered the request queue
+      uint64_t getEnqueueCycle() { return EnqueueCycle; }
+
+      /// RevMemOp: set the cycle the op was issued to memory
+      void setIssueCycle(uint64_t C) { IssueCycle = C; }
+
+      /// RevMemOp: retrieve the cycle the op was issued to memory
+      uint64_t getIssueCycle() { return IssueCycle; }
+
       // RevMemOp: determine if the request is cache-able
       bool isCacheable() { if( (flags & 0b10) > 0 ){ return false; } return true; }
 
+      // RevMemOp: determine if the request is an atomic read-modify-write
+      bool isAMO() { return ((uint32_t)(flags) & _REV_AMO_FLAGS_) != 0; }
+
+      // RevMemOp: determine if the request is an instruction fetch
+      bool isIFetch() { return ((uint32_t)(flags) & (uint32_t)(RevFlag::F_IFETCH)) != 0; }
+
     private:
       uint64_t Addr;      ///< RevMemOp: address
       uint64_t PAddr;     ///< RevMemOp: physical address (for RevMem I/O)
@@ -176,9 +272,17 @@ namespace SST {
       MemOp Op;           ///< RevMemOp: target memory operation
       unsigned CustomOpc; ///< RevMemOp: custom memory opcode
       unsigned SplitRqst; ///< RevMemOp: number of split cache line requests
-      std::vector<uint8_t> membuf;          ///< RevMemOp: buffer
+      unsigned SplitLeft; ///< RevMemOp: number of split cache line requests still in flight
+      uint8_t inlineBuf[_REV_MEMOP_INLINE_]; ///< RevMemOp: buffer for requests up to a cache line
+      std::vector<uint8_t> membuf;          ///< RevMemOp: buffer for larger requests
       StandardMem::Request::flags_t flags;  ///< RevMemOp: request flags
       void *target;                         ///< RevMemOp: target register pointer
+      unsigned Core = 0;                    ///< RevMemOp: issuing core
+      uint64_t EnqueueCycle = 0;            ///< RevMemOp: cycle the op entered the request queue
+      uint64_t IssueCycle = 0;              ///< RevMemOp: cycle the op was issued to memory
+
+      /// RevMemOp: copy the request payload into the op
+      void setBuf(const char *buffer);
     };
 
     // ----------------------------------------
@@ -210,6 +314,29 @@ namespace SST {
       /// RevMemCtrl: determines if outstanding requests exist
       virtual bool outstandingRqsts() = 0;
 
+      /// RevMemCtrl: set the PC of the instruction issuing the next requests
+      void setActivePC(uint64_t PC) { activePC = PC; }
+
+      /// RevMemCtrl: set the core issuing the next requests
+      void setActiveCore(unsigned Core) { activeCore = Core; }
+
+      /// RevMemCtrl: set the number of cores issuing requests; used for per-core state and statistics
+      virtual void setNumCores(unsigned Cores) { fetchStalled.resize(Cores, false); }
+
+      /// RevMemCtrl: record whether the front end of the target core is stalled waiting on instruction fetch
+      void setFetchStall(unsigned Core, bool Stalled){
+        if( (Core < fetchStalled.size()) && (fetchStalled[Core] != Stalled) ){
+          fetchStalled[Core] = Stalled;
+          if( Stalled )
+            numFetchStalled++;
+          else
+            numFetchStalled--;
+        }
+      }
+
+      /// RevMemCtrl: retrieve the number of queued and in-flight requests
+      virtual uint64_t getNumPendingRqsts() = 0;
+
       /// RevMemCtrl: send flush request
       virtual bool sendFLUSHRequest(uint64_t Addr, uint64_t PAddr,
                                     uint32_t Size, bool Inv,
@@ -235,6 +362,11 @@ namespace SST {
                                         uint32_t Size, char *buffer,
                                         StandardMem::Request::flags_t flags) = 0;
 
+      /// RevMemCtrl: send an atomic read-modify-write request; the prior value is returned in target
+      virtual bool sendAMORequest(uint64_t Addr, uint64_t PAddr,
+                                  uint32_t Size, char *buffer, void *target,
+                                  StandardMem::Request::flags_t flags) = 0;
+
       /// RevMemCtrl: send a loadlink request
       virtual bool sendLOADLINKRequest(uint64_t Addr, uint64_t PAddr,
                                        uint32_t Size,
@@ -283,6 +415,10 @@ namespace SST {
 
     protected:
       SST::Output *output;        ///< RevMemCtrl: sst output object
+      uint64_t activePC;          ///< RevMemCtrl: PC of the instruction issuing the current requests
+      unsigned activeCore;        ///< RevMemCtrl: core issuing the current requests
+      std::vector<bool> fetchStalled; ///< RevMemCtrl: per-core flag set while the front end waits on instruction fetch
+      unsigned numFetchStalled = 0;   ///< RevMemCtrl: number of cores whose front end is stalled
     }; // class RevMemCtrl
 
     // ----------------------------------------
@@ -306,10 +442,16 @@ namespace SST {
                               { "max_readlock",   "Sets the maxmium number of outstanding readlock events",   "64"},
                               { "max_writeunlock","Sets the maximum number of outstanding writeunlock events","64"},
                               { "max_custom",     "Sets the maximum number of outstanding custom events",     "64"},
-                              { "ops_per_cycle",  "Sets the maximum number of operations to issue per cycle", "2" }
+                              { "ops_per_cycle",  "Sets the maximum number of operations to issue per cycle", "2" },
+                              { "coalesce_loads", "Merge cacheable reads to a line with an outstanding fill",   "0" },
+                              { "wbuf_entries",   "Sets the number of lines in the posted write buffer; 0 disables it", "0" },
+                              { "wbuf_drain_age", "Sets the number of cycles a write buffer line may gather stores",    "16" },
+                              { "pf_queue",       "Sets the number of prefetch candidates waiting to issue",            "32" }
       )
 
-      SST_ELI_DOCUMENT_SUBCOMPONENT_SLOTS({ "memIface", "Set the interface to memory", "SST::Interfaces::StandardMem" })
+      SST_ELI_DOCUMENT_SUBCOMPONENT_SLOTS({ "memIface",   "Set the interface to memory", "SST::Interfaces::StandardMem" },
+                                          { "instIface",  "Set the interface to memory for instruction fetch; defaults to memIface", "SST::Interfaces::StandardMem" },
+                                          { "prefetcher", "Set the data prefetcher",     "SST::RevCPU::RevDataPrefetcher" })
 
       SST_ELI_DOCUMENT_PORTS()
 
@@ -335,7 +477,35 @@ namespace SST {
         {"CustomInFlight",      "Counts the number of custom commands in flight",   "count", 1},
         {"CustomPending",       "Counts the number of custom commands pending",     "count", 1},
         {"CustomBytes",         "Counts the number of bytes in custom transactions","bytes", 1},
-        {"FencePending",        "Counts the number of fence operations pending",    "count", 1}
+        {"FencePending",        "Counts the number of fence operations pending",    "count", 1},
+        {"ReadCoalesced",       "Counts the number of reads merged into an outstanding line fill", "count", 1},
+        {"MSHRLines",           "Number of outstanding line fills when a new fill is issued",      "count", 1},
+        {"WriteBufMerged",      "Counts the number of stores merged into a buffered line",         "count", 1},
+        {"WriteBufForward",     "Counts the number of reads satisfied from the write buffer",      "count", 1},
+        {"WriteBufDrain",       "Counts the number of write buffer lines drained to memory",       "count", 1},
+        {"PrefetchIssued",      "Counts the number of prefetch line reads issued",                 "count", 1},
+        {"PrefetchUseful",      "Counts the number of prefetched lines later read on demand",      "count", 1},
+        {"PrefetchLate",        "Counts the number of demand reads to a line still being prefetched", "count", 1},
+        {"PrefetchDemand",      "Counts the number of demand reads observed by the prefetcher",    "count", 1},
+        {"ReadOutstanding",     "Number of outstanding reads, sampled every active cycle",          "count", 1},
+        {"WriteOutstanding",    "Number of outstanding writes, sampled every active cycle",         "count", 1},
+        {"PrefetchOutstanding", "Number of prefetches in flight, sampled every active cycle",       "count", 1},
+        {"ReadQueueDelay",        "Cycles a read waited in the queue before issue", "cycles", 1},
+        {"ReadLatency",           "Cycles from issue of a read to its response", "cycles", 1},
+        {"WriteQueueDelay",       "Cycles a write waited in the queue before issue", "cycles", 1},
+        {"WriteLatency",          "Cycles from issue of a write to its response", "cycles", 1},
+        {"FlushQueueDelay",       "Cycles a flush waited in the queue before issue", "cycles", 1},
+        {"FlushLatency",          "Cycles from issue of a flush to its response", "cycles", 1},
+        {"ReadLockQueueDelay",    "Cycles a readlock waited in the queue before issue", "cycles", 1},
+        {"ReadLockLatency",       "Cycles from issue of a readlock to its response", "cycles", 1},
+        {"WriteUnlockQueueDelay", "Cycles a write unlock waited in the queue before issue", "cycles", 1},
+        {"WriteUnlockLatency",    "Cycles from issue of a write unlock to its response", "cycles", 1},
+        {"LoadLinkQueueDelay",    "Cycles a loadlink waited in the queue before issue", "cycles", 1},
+        {"LoadLinkLatency",       "Cycles from issue of a loadlink to its response", "cycles", 1},
+        {"StoreCondQueueDelay",   "Cycles a storecond waited in the queue before issue", "cycles", 1},
+        {"StoreCondLatency",      "Cycles from issue of a storecond to its response", "cycles", 1},
+        {"CustomQueueDelay",      "Cycles a custom command waited in the queue before issue", "cycles", 1},
+        {"CustomLatency",         "Cycles from issue of a custom command to its response", "cycles", 1}
       )
 
       typedef enum{
@@ -360,7 +530,19 @@ namespace SST {
         CustomInFlight      = 18,
         CustomPending       = 19,
         CustomBytes         = 20,
-        FencePending        = 21
+        FencePending        = 21,
+        ReadCoalesced       = 22,
+        MSHRLines           = 23,
+        WriteBufMerged      = 24,
+        WriteBufForward     = 25,
+        WriteBufDrain       = 26,
+        PrefetchIssued      = 27,
+        PrefetchUseful      = 28,
+        PrefetchLate        = 29,
+        PrefetchDemand      = 30,
+        ReadOutstanding     = 31,
+        WriteOutstanding    = 32,
+        PrefetchOutstanding = 33
       }MemCtrlStats;
 
       /// RevBasicMemCtrl: constructor
@@ -384,9 +566,15 @@ namespace SST {
       /// RevBasicMemCtrl: determines if outstanding requests exist
       bool outstandingRqsts() override;
 
+      /// RevBasicMemCtrl: retrieve the number of queued and in-flight requests
+      uint64_t getNumPendingRqsts() override;
+
       /// RevBasicMemCtrl: returns the cache line size
       unsigned getLineSize() override { return lineSize; }
 
+      /// RevBasicMemCtrl: register the per-core queueing delay and latency statistics
+      void setNumCores(unsigned Cores) override;
+
       /// RevBasicMemCtrl: memory event processing handler
       void processMemEvent(StandardMem::Request* ev);
 
@@ -415,6 +603,11 @@ namespace SST {
                                         uint32_t Size, char *buffer,
                                         StandardMem::Request::flags_t flags) override;
 
+      // RevBasicMemCtrl: send an atomic read-modify-write request
+      virtual bool sendAMORequest(uint64_t Addr, uint64_t PAddr,
+                                  uint32_t Size, char *buffer, void *target,
+                                  StandardMem::Request::flags_t flags) override;
+
       // RevBasicMemCtrl: send a loadlink request
       virtual bool sendLOADLINKRequest(uint64_t Addr, uint64_t PAddr,
                                        uint32_t Size,
@@ -493,11 +686,62 @@ namespace SST {
 
     private:
 
-      /// RevBasicMemCtrl: process the next memory request
+      /// RevBasicMemCtrl: write buffer entry; the posted store data for one cache line
+      struct RevWBufEntry {
+        uint64_t Line;                        ///< line address
+        uint64_t PLine;                       ///< RevMem physical address of the line
+        uint64_t Cycle;                       ///< cycle the line was allocated
+        unsigned Core;                        ///< core of the first store gathered in the line
+        unsigned NumValid;                    ///< number of bytes written
+        StandardMem::Request::flags_t Flags;  ///< flags of the stores gathered in the line
+        std::vector<uint8_t> Data;            ///< line data
+        std::vector<uint8_t> Valid;           ///< nonzero for each byte written
+      };
+
+      /// RevBasicMemCtrl: request queue classes; each class is a FIFO with its own issue limit
+      typedef enum{
+        RqstREAD            = 0,
+        RqstWRITE           = 1,
+        RqstFLUSH           = 2,
+        RqstLLSC            = 3,
+        RqstREADLOCK        = 4,
+        RqstWRITEUNLOCK     = 5,
+        RqstCUSTOM          = 6,
+        RqstFENCE           = 7,
+        RqstIFETCH          = 8,
+        RqstNumClasses      = 9
+      }RqstClass;
+
+      /// RevBasicMemCtrl: retrieve the request queue class of the target op
+      RqstClass getRqstClass(RevMemOp *op);
+
+      /// RevBasicMemCtrl: append an op to the queue of its class
+      void enqueueRqst(RevMemOp *op){
+        if( !clockActive )
+          wakeClock();
+        op->setCore(activeCore);
+        op->setEnqueueCycle(curCycle);
+        rqstQ[getRqstClass(op)].push_back(std::make_pair(rqstSeq++, op));
+        numQueued++;
+      }
+
+      /// RevBasicMemCtrl: re-register the clock handler after the controller went idle
+      void wakeClock();
+
+      /// RevBasicMemCtrl: retrieve the current controller cycle; curCycle goes stale while the clock is released
+      uint64_t getCycle() { return getCurrentSimTime(timeConverter); }
+
+      /// RevBasicMemCtrl: determine if the clock can be released until new work arrives
+      bool isIdle(){
+        return (numQueued == 0) && (num_fence == 0) && wbuf.empty() && pfQueue.empty();
+      }
+
+      /// RevBasicMemCtrl: process the next memory request; t_idle_ops receives the issue slots left unused
       bool processNextRqst(unsigned &t_max_loads, unsigned &t_max_stores,
                            unsigned &t_max_flush, unsigned &t_max_llsc,
                            unsigned &t_max_readlock, unsigned &t_max_writeunlock,
-                           unsigned &t_max_custom, unsigned &t_max_ops);
+                           unsigned &t_max_custom, unsigned &t_max_ops,
+                           unsigned &t_idle_ops);
 
       /// RevBasicMemCtrl: determine if we can instantiate the target memory operation
       bool isMemOpAvail(RevMemOp *Op, unsigned &t_max_loads, unsigned &t_max_stores,
@@ -506,7 +750,8 @@ namespace SST {
                         unsigned &t_max_custom);
 
       /// RevBasicMemCtrl: build a standard memory request
-      bool buildStandardMemRqst(RevMemOp *op, bool &Success);
+      bool buildStandardMemRqst(RevMemOp *op, bool &Success,
+                                unsigned &t_max_stores, unsigned &t_max_ops);
 
       /// RevBasicMemCtrl: build raw memory requests with a 1-to-1 mapping to RevMemOps'
       bool buildRawMemRqst(RevMemOp *op, StandardMem::Request::flags_t TmpFlags);
@@ -514,9 +759,66 @@ namespace SST {
       /// RevBasicMemCtrl: build cache-aligned requests
       bool buildCacheMemRqst(RevMemOp *op, bool &Success);
 
+      /// RevBasicMemCtrl: merge a read into an outstanding line fill or issue a new fill; false if the read is not eligible.
+      /// Success is cleared when every load slot is in use
+      bool coalesceRead(RevMemOp *op, bool &Success);
+
+      /// RevBasicMemCtrl: stop merging reads into the fills of the lines touched by the target op
+      void closeMSHRs(RevMemOp *op);
+
+      /// RevBasicMemCtrl: deliver a completed line fill to each read waiting on it
+      void handleMSHRResp(StandardMem::ReadResp* ev, std::vector<RevMemOp *> &Waiters);
+
+      /// RevBasicMemCtrl: determine if the target op may use the write buffer
+      bool isWBufEligible(RevMemOp *op){
+        return hasCache && op->isCacheable() && !op->isAMO() &&
+               (getNumCacheLines(op->getAddr(), op->getSize()) == 1);
+      }
+
+      /// RevBasicMemCtrl: drain a write buffer line for the target op with the store and op slots left this cycle; false if part of it stays buffered
+      bool forceDrainWBufEntry(RevMemOp *op, std::deque<RevWBufEntry>::iterator it,
+                               unsigned &t_max_stores, unsigned &t_max_ops);
+
+      /// RevBasicMemCtrl: determine if the op still fits in this cycle after forced drains
+      bool wbufFits(unsigned t_max_stores, unsigned t_max_ops){
+        return (t_max_ops <= max_ops) && (t_max_stores <= max_stores);
+      }
+
+      /// RevBasicMemCtrl: gather a write into the write buffer; false if the write must be issued directly.
+      /// Success is cleared when the write must wait for the next cycle
+      bool postWrite(RevMemOp *op, unsigned &t_max_stores, unsigned &t_max_ops, bool &Success);
+
+      /// RevBasicMemCtrl: satisfy a read from the write buffer; false if the read must be issued to memory.
+      /// Success is cleared when the read must wait for the next cycle
+      bool forwardRead(RevMemOp *op, unsigned &t_max_stores, unsigned &t_max_ops, bool &Success);
+
+      /// RevBasicMemCtrl: drain the write buffer lines touched by the target op; false if the cycle ran out of store slots
+      bool drainWBufLines(RevMemOp *op, unsigned &t_max_stores, unsigned &t_max_ops);
+
+      /// RevBasicMemCtrl: issue up to Budget of the stores held in a write buffer line; true once the line is released
+      bool drainWBufEntry(std::deque<RevWBufEntry>::iterator it, unsigned &Budget);
+
+      /// RevBasicMemCtrl: drain aged, complete or overflowing write buffer lines; Force drains every line
+      void drainWBuf(unsigned &t_max_stores, bool Force);
+
+      /// RevBasicMemCtrl: score a demand read against the prefetched lines and train the prefetcher
+      void observeRead(uint64_t Addr, uint32_t Size, StandardMem::Request::flags_t flags);
+
+      /// RevBasicMemCtrl: issue queued prefetches with the read and issue slots left idle this cycle
+      void issuePrefetches(unsigned &t_max_loads, unsigned &t_idle_ops);
+
+      /// RevBasicMemCtrl: complete the read half of an AMO and issue the locked write
+      void handleAMOResp(StandardMem::ReadResp* ev, RevMemOp *op);
+
+      /// RevBasicMemCtrl: retire the outstanding request count for the target operation
+      void retireRqst(RevMemOp::MemOp Op);
+
       /// RevBasicMemCtrl: register statistics
       void registerStats();
 
+      /// RevBasicMemCtrl: record the queueing delay and latency of a completed op
+      void recordLatency(RevMemOp *op);
+
       /// RevBasicMemCtrl: inject statistics data for the target metric
       void recordStat(MemCtrlStats Stat, uint64_t Data);
 
@@ -529,11 +831,29 @@ namespace SST {
       /// RevBasicMemCtrl: Retrieve the base cache line request size
       unsigned getBaseCacheLineSize(uint64_t Addr, uint32_t Size);
 
-      /// RevBasicMemCtrl: retrieve the number of outstanding requests on the wire
-      unsigned getNumSplitRqsts(RevMemOp *op);
+      /// RevBasicMemCtrl: retrieve the interface that carries the target op
+      StandardMem *getIface(RevMemOp *op){
+        return (instIface && op->isIFetch()) ? instIface : memIface;
+      }
+
+      /// RevBasicMemCtrl: record a request sent on the memory interface on behalf of the target op
+      void trackRqst(StandardMem::Request *rqst, RevMemOp *op){
+        outstanding.emplace(rqst->getID(), op);
+      }
+
+      /// RevBasicMemCtrl: remove and return the op that issued the target request; nullptr if unknown
+      RevMemOp *takeRqst(StandardMem::Request::id_t id){
+        auto it = outstanding.find(id);
+        if( it == outstanding.end() )
+          return nullptr;
+        RevMemOp *op = it->second;
+        outstanding.erase(it);
+        return op;
+      }
 
       // -- private data members
       StandardMem* memIface;                  ///< StandardMem memory interface
+      StandardMem* instIface;                 ///< StandardMem instruction fetch interface; nullptr if fetch shares memIface
       RevStdMemHandlers* stdMemHandlers;      ///< StandardMem interface response handlers
       bool hasCache;                          ///< detects whether cache layers are present
       unsigned lineSize;                      ///< cache line size
@@ -545,6 +865,13 @@ namespace SST {
       unsigned max_writeunlock;               ///< maximum number of oustanding writelock events
       unsigned max_custom;                    ///< maximum number of oustanding custom events
       unsigned max_ops;                       ///< maximum number of ops to issue per cycle
+      bool coalesceLoads;                     ///< merge reads into outstanding line fills
+      unsigned wbufEntries;                   ///< number of lines in the write buffer; 0 disables it
+      unsigned wbufDrainAge;                  ///< cycles a write buffer line may gather stores before it drains
+      uint64_t curCycle;                      ///< current controller cycle
+      TimeConverter* timeConverter;           ///< controller clock
+      Clock::Handler<RevBasicMemCtrl>* clockHandler; ///< controller clock handler
+      bool clockActive;                       ///< the clock handler is registered
 
       uint64_t num_read;                      ///< number of outstanding read requests
       uint64_t num_write;                     ///< number of outstanding write requests
@@ -555,11 +882,29 @@ namespace SST {
       uint64_t num_custom;                    ///< number of outstanding custom requests
       uint64_t num_fence;                     ///< number of oustanding fence requests
 
-      std::vector<StandardMem::Request::id_t> requests;               ///< outstanding StandardMem requests
-      std::vector<RevMemOp *> rqstQ;                                  ///< queued memory requests
-      std::map<StandardMem::Request::id_t,RevMemOp *> outstanding;    ///< map of outstanding requests
+      std::deque<std::pair<uint64_t,RevMemOp *>> rqstQ[RqstNumClasses]; ///< queued memory requests per class; pair<Seq,Op>
+      uint64_t rqstSeq;                       ///< sequence number assigned to the next queued request
+      uint64_t numQueued;                     ///< number of queued memory requests
+      std::unordered_map<StandardMem::Request::id_t,RevMemOp *> outstanding; ///< outstanding StandardMem requests and their ops
+      std::unordered_map<uint64_t,StandardMem::Request::id_t> mshrOpen;   ///< lines whose fill can absorb more reads; line address -> fill request
+      std::unordered_map<StandardMem::Request::id_t,std::vector<RevMemOp *>> mshrWaiters; ///< reads merged into each outstanding fill
+      std::deque<RevWBufEntry> wbuf;          ///< posted write buffer, oldest line first
+
+      RevDataPrefetcher *prefetcher;          ///< data prefetcher; nullptr if none is loaded
+      unsigned pfQueueSize;                   ///< maximum number of prefetch candidates waiting to issue
+      std::deque<uint64_t> pfQueue;           ///< prefetch candidates waiting to issue, oldest first
+      std::unordered_map<uint64_t,std::pair<uint64_t,bool>> pfLines; ///< prefetched lines not yet read on demand; line -> (issue number, fill arrived)
+      std::deque<std::pair<uint64_t,uint64_t>> pfOrder; ///< prefetched lines and issue numbers, oldest first
+      std::unordered_map<StandardMem::Request::id_t,uint64_t> pfRqsts; ///< outstanding prefetch requests and their lines
+      std::vector<uint64_t> pfCandidates;     ///< scratch space for the prefetcher's proposals
+      uint64_t pfIssued;                      ///< number of prefetches issued
+      uint64_t pfUseful;                      ///< number of prefetched lines read on demand
+      uint64_t pfLate;                        ///< number of demand reads that found the prefetch in flight
+      uint64_t pfDemand;                      ///< number of demand reads observed
 
       std::vector<Statistic<uint64_t>*> stats;                        ///< statistics vector
+      Statistic<uint64_t>* latStats[_REV_LAT_CLASSES_][2];            ///< queueing delay and latency statistics per op class
+      std::vector<std::vector<Statistic<uint64_t>*>> coreLatStats;    ///< per-core latStats, flattened as [core][class*2+kind]
 
     }; // RevBasicMemCtrl
   } // namespace RevCPU
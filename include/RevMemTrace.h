@@ -0,0 +1,204 @@
+//
+// _RevMemTrace_h_
+//
+// Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+//
+// See LICENSE in the top level directory for licensing details
+//
+
+#ifndef _SST_REVCPU_REVMEMTRACE_H_
+#define _SST_REVCPU_REVMEMTRACE_H_
+
+// -- C++ Headers
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// -- SST Headers
+#include <sst/core/sst_config.h>
+#include <sst/core/output.h>
+
+#define _REV_TRACE_MAGIC_   "REVTRACE"      ///< RevMemTrace: file magic
+#define _REV_TRACE_VERSION_ 1               ///< RevMemTrace: file format version
+#define _REV_TRACE_QUEUE_   4               ///< RevMemTrace: full buffers queued before the producer blocks
+
+namespace SST {
+  namespace RevCPU {
+
+    /// RevTraceOp: traced operation type
+    enum class RevTraceOp : uint8_t {
+      READ   = 0,                   ///< RevTraceOp: load
+      WRITE  = 1,                   ///< RevTraceOp: store
+      AMO    = 2,                   ///< RevTraceOp: atomic read-modify-write
+      FENCE  = 3                    ///< RevTraceOp: memory fence
+    };
+
+    /// RevTraceRecord: a single traced memory access
+    struct RevTraceRecord {
+      uint64_t Cycle;               ///< RevTraceRecord: issue cycle
+      unsigned Core;                ///< RevTraceRecord: issuing core
+      unsigned Hart;                ///< RevTraceRecord: issuing hart
+      uint64_t PC;                  ///< RevTraceRecord: PC of the issuing instruction
+      uint64_t VAddr;               ///< RevTraceRecord: virtual address
+      uint64_t PAddr;               ///< RevTraceRecord: physical address
+      uint32_t Size;                ///< RevTraceRecord: access size in bytes
+      RevTraceOp Op;                ///< RevTraceRecord: operation type
+      uint32_t Flags;               ///< RevTraceRecord: RevFlag request flags
+    };
+
+    // ----------------------------------------
+    // RevMemTrace
+    // ----------------------------------------
+    // Compact binary memory access trace.  Every record is delta
+    // encoded against its predecessor using zigzag varints, and the
+    // core/hart and flags fields are only emitted when they change or
+    // are non-zero.  Records are encoded into a local buffer; full
+    // buffers are handed to a writer thread so that the simulation
+    // never blocks on file I/O unless the writer falls behind.
+    //
+    // File layout: "REVTRACE" <u8 version> then a stream of
+    //   u8      Op | CTX<<4 | FLAGS<<5
+    //   varint  zigzag(Cycle - prevCycle)
+    //   [CTX]   varint Core, varint Hart
+    //   varint  zigzag(PC - prevPC)
+    //   varint  zigzag(VAddr - prevVAddr)
+    //   varint  zigzag((PAddr - VAddr) - prev(PAddr - VAddr))
+    //   varint  Size
+    //   [FLAGS] varint Flags
+    class RevMemTrace {
+    public:
+      /// RevMemTrace: bit set in the header byte when the core/hart follows
+      static const uint8_t HDR_CTX   = 1u << 4;
+
+      /// RevMemTrace: bit set in the header byte when the flags follow
+      static const uint8_t HDR_FLAGS = 1u << 5;
+
+      /// RevMemTrace: constructor; opens the trace file and starts the writer thread
+      RevMemTrace( const std::string &File, uint64_t BufSize, SST::Output *Output );
+
+      /// RevMemTrace: destructor; drains the buffers and joins the writer thread
+      ~RevMemTrace();
+
+      /// RevMemTrace: restrict tracing to addresses in [Min, Max]
+      void SetAddrRange( uint64_t Min, uint64_t Max ){ minAddr = Min; maxAddr = Max; }
+
+      /// RevMemTrace: restrict tracing to cycles in [Start, Stop]
+      void SetCycleWindow( uint64_t Start, uint64_t Stop ){ startCycle = Start; stopCycle = Stop; }
+
+      /// RevMemTrace: determine whether an access at the target cycle and address is traced
+      bool Filter( uint64_t Cycle, uint64_t Addr ){
+        return (Cycle >= startCycle) && (Cycle <= stopCycle) &&
+               (Addr >= minAddr) && (Addr <= maxAddr);
+      }
+
+      /// RevMemTrace: encode a record
+      void Record( const RevTraceRecord &R );
+
+      /// RevMemTrace: retrieve the number of records written
+      uint64_t GetNumRecords() { return numRecords; }
+
+    private:
+      FILE *file;                                   ///< RevMemTrace: trace file
+      uint64_t bufSize;                             ///< RevMemTrace: bytes per buffer before it is handed off
+      SST::Output *output;                          ///< RevMemTrace: output handler
+
+      uint64_t minAddr;                             ///< RevMemTrace: lowest traced address
+      uint64_t maxAddr;                             ///< RevMemTrace: highest traced address
+      uint64_t startCycle;                          ///< RevMemTrace: first traced cycle
+      uint64_t stopCycle;                           ///< RevMemTrace: last traced cycle
+      uint64_t numRecords;                          ///< RevMemTrace: number of records encoded
+
+      RevTraceRecord prev;                          ///< RevMemTrace: previous record; delta base
+
+      std::vector<uint8_t> cur;                     ///< RevMemTrace: buffer being filled by the simulation
+      std::deque<std::vector<uint8_t>> full;        ///< RevMemTrace: buffers waiting to be written
+      std::vector<std::vector<uint8_t>> spare;      ///< RevMemTrace: drained buffers available for reuse
+      std::mutex mtx;                               ///< RevMemTrace: protects full, spare and done
+      std::condition_variable cv;                   ///< RevMemTrace: signals the writer thread
+      std::condition_variable drained;              ///< RevMemTrace: signals the producer when the queue has room
+      bool done;                                    ///< RevMemTrace: no further buffers will be queued
+      std::thread writer;                           ///< RevMemTrace: writer thread
+
+      /// RevMemTrace: append an unsigned LEB128 varint
+      void PutVarint( uint64_t V ){
+        while( V >= 0x80 ){
+          cur.push_back((uint8_t)(V | 0x80));
+          V >>= 7;
+        }
+        cur.push_back((uint8_t)(V));
+      }
+
+      /// RevMemTrace: append a signed delta as a zigzag varint
+      void PutDelta( uint64_t Cur, uint64_t Prev ){
+        const int64_t D = (int64_t)(Cur - Prev);
+        PutVarint(((uint64_t)(D) << 1) ^ (uint64_t)(D >> 63));
+      }
+
+      /// RevMemTrace: hand the current buffer to the writer thread
+      void Flush();
+
+      /// RevMemTrace: writer thread body
+      void WriterLoop();
+    }; // class RevMemTrace
+
+    // ----------------------------------------
+    // RevMemTraceReader
+    // ----------------------------------------
+    // Sequential decoder for traces written by RevMemTrace
+    class RevMemTraceReader {
+    public:
+      /// RevMemTraceReader: constructor; opens the trace and validates the header
+      RevMemTraceReader( const std::string &File, SST::Output *Output );
+
+      /// RevMemTraceReader: destructor
+      ~RevMemTraceReader();
+
+      /// RevMemTraceReader: decode the next record; returns false at the end of the trace
+      bool Next( RevTraceRecord &R );
+
+      /// RevMemTraceReader: retrieve the number of records decoded
+      uint64_t GetNumRecords() { return numRecords; }
+
+    private:
+      FILE *file;                   ///< RevMemTraceReader: trace file
+      SST::Output *output;          ///< RevMemTraceReader: output handler
+      uint64_t numRecords;          ///< RevMemTraceReader: number of records decoded
+      RevTraceRecord prev;          ///< RevMemTraceReader: previous record; delta base
+      std::vector<uint8_t> buf;     ///< RevMemTraceReader: read buffer
+      size_t pos;                   ///< RevMemTraceReader: next unread byte in buf
+      size_t len;                   ///< RevMemTraceReader: number of valid bytes in buf
+
+      /// RevMemTraceReader: retrieve the next byte; returns false at the end of the file
+      bool GetByte( uint8_t &B ){
+        if( pos == len ){
+          len = fread(buf.data(), 1, buf.size(), file);
+          pos = 0;
+          if( len == 0 )
+            return false;
+        }
+        B = buf[pos++];
+        return true;
+      }
+
+      /// RevMemTraceReader: decode an unsigned LEB128 varint
+      uint64_t GetVarint();
+
+      /// RevMemTraceReader: decode a zigzag delta against the target base
+      uint64_t GetDelta( uint64_t Prev ){
+        const uint64_t Z = GetVarint();
+        return Prev + (uint64_t)((int64_t)(Z >> 1) ^ -(int64_t)(Z & 1));
+      }
+    }; // class RevMemTraceReader
+  } // namespace RevCPU
+} // namespace SST
+
+#endif // _SST_REVCPU_REVMEMTRACE_H_
+
+// EOF
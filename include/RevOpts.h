@@ -30,6 +30,15 @@ using namespace SST::RevCPU;
 
 namespace SST {
   namespace RevCPU {
+    /// RevMemRegion: address range with its own memory latency
+    struct RevMemRegion {
+      uint64_t Base;                ///< RevMemRegion: base address
+      uint64_t Size;                ///< RevMemRegion: size in bytes
+      unsigned MinCost;             ///< RevMemRegion: minimum latency in cycles
+      unsigned MaxCost;             ///< RevMemRegion: maximum latency in cycles
+      uint64_t Bandwidth;           ///< RevMemRegion: bytes per cycle; 0 is unlimited
+    };
+
     class RevOpts{
     public:
       /// RevOpts: options constructor
@@ -62,6 +71,9 @@ namespace SST {
       /// RevOpts: initialize the prefetch depths
       bool InitPrefetchDepth( std::vector<std::string> Depths );
 
+      /// RevOpts: initialize the region-specific memory latency table
+      bool InitMemRegions( std::vector<std::string> Regions );
+
       /// RevOpts: retrieve the start address for the target core
       bool GetStartAddr( unsigned Core, uint64_t &StartAddr );
 
@@ -80,6 +92,9 @@ namespace SST {
       /// RevOpts: retrieve the prefetch depth for the target core
       bool GetPrefetchDepth( unsigned Core, unsigned &Depth );
 
+      /// RevOpts: retrieve the region-specific memory latency table
+      const std::vector<RevMemRegion>& GetMemRegions() { return memRegions; }
+
     private:
       unsigned numCores;                            ///< RevOpts: number of initialized cores
       int verbosity;                                ///< RevOpts: verbosity level
@@ -92,6 +107,8 @@ namespace SST {
 
       std::vector<std::pair<unsigned,unsigned>> memCosts; ///< RevOpts: vector of memory cost ranges
 
+      std::vector<RevMemRegion> memRegions;         ///< RevOpts: region-specific memory latencies
+
       /// RevOpts: splits a string into tokens
       void splitStr(const std::string& s,char c,std::vector<std::string>& v);
 
@@ -0,0 +1,140 @@
+//
+// _RevPageTable_h_
+//
+// Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+//
+// See LICENSE in the top level directory for licensing details
+//
+
+#ifndef _SST_REVCPU_REVPAGETABLE_H_
+#define _SST_REVCPU_REVPAGETABLE_H_
+
+// -- C++ Headers
+#include <cstdint>
+
+// -- SST Headers
+#include <sst/core/sst_config.h>
+#include <sst/core/output.h>
+
+#ifndef _INVALID_ADDR_
+#define _INVALID_ADDR_ 0xFFFFFFFFFFFFFFFF
+#endif
+
+namespace SST {
+  namespace RevCPU {
+
+    /// RevPTEFlags: page table entry flags
+    enum RevPTEFlags : uint32_t {
+      PTE_VALID   = 1u << 0,      ///< RevPTEFlags: the entry maps a physical page
+    };
+
+    /// RevPTE: leaf page table entry
+    struct RevPTE {
+      uint64_t PPN;               ///< RevPTE: physical page number
+      uint32_t Flags;             ///< RevPTE: RevPTEFlags
+      uint64_t Reads;             ///< RevPTE: heat map: number of reads
+      uint64_t Writes;            ///< RevPTE: heat map: number of writes
+      uint64_t FirstTouch;        ///< RevPTE: heat map: cycle of the first access
+      uint64_t LastTouch;         ///< RevPTE: heat map: cycle of the most recent access
+      uint64_t Cores;             ///< RevPTE: heat map: mask of the cores that touched the page (core % 64)
+      uint64_t Interval;          ///< RevPTE: heat map: number of accesses since the last interval dump
+    };
+
+    // ----------------------------------------
+    // RevPageTable
+    // ----------------------------------------
+    // Multi-level radix page table indexed by virtual page number.
+    // Each level resolves BitsPerLevel bits of the VPN (the root
+    // resolves whatever remains), so a BitsPerLevel of 9 mirrors
+    // the Sv39/Sv48 walk structure.  Interior and leaf nodes are
+    // allocated on first touch.
+    class RevPageTable {
+    public:
+      /// RevPageTable: constructor
+      RevPageTable( unsigned VPNBits, unsigned BitsPerLevel, SST::Output *Output );
+
+      /// RevPageTable: destructor
+      ~RevPageTable();
+
+      /// RevPageTable: retrieve the entry for the target page; nullptr if the walk is not populated
+      RevPTE *Find( uint64_t VPN ){
+        if( (VPN >> bits) == lastLeafTag )
+          return &lastLeaf[VPN & levelMask];
+        void **Node = root;
+        for( unsigned l=0; l<levels-1; l++ ){
+          Node = (void **)(Node[Index(VPN, l)]);
+          if( !Node )
+            return nullptr;
+        }
+        lastLeafTag = VPN >> bits;
+        lastLeaf = (RevPTE *)(Node);
+        return &lastLeaf[VPN & levelMask];
+      }
+
+      /// RevPageTable: retrieve the entry for the target page, populating the walk on first touch
+      RevPTE *Walk( uint64_t VPN );
+
+      /// RevPageTable: number of valid leaf entries
+      uint64_t GetNumMapped() { return numMapped; }
+
+      /// RevPageTable: record that a leaf entry was made valid
+      void MarkMapped() { numMapped++; }
+
+      /// RevPageTable: retrieve the number of levels
+      unsigned GetLevels() { return levels; }
+
+      /// RevPageTable: retrieve the number of VPN bits resolved per level
+      unsigned GetBitsPerLevel() { return bits; }
+
+      /// RevPageTable: invoke Fn(VPN, PTE) for every valid leaf entry in ascending VPN order
+      template <typename F>
+      void ForEach( F Fn ){ ForEachNode(root, 0, 0, Fn); }
+
+    private:
+      unsigned levels;            ///< RevPageTable: number of levels, including the leaf
+      unsigned bits;              ///< RevPageTable: VPN bits per non-root level
+      unsigned rootBits;          ///< RevPageTable: VPN bits resolved by the root
+      uint64_t levelMask;         ///< RevPageTable: mask for a non-root level index
+      uint64_t numMapped;         ///< RevPageTable: number of valid leaf entries
+      void **root;                ///< RevPageTable: root node
+      uint64_t lastLeafTag;       ///< RevPageTable: VPN bits above the leaf index of the last leaf touched
+      RevPTE *lastLeaf;           ///< RevPageTable: last leaf node touched
+      SST::Output *output;        ///< RevPageTable: output handler
+
+      /// RevPageTable: derive the node index for the target level
+      uint64_t Index( uint64_t VPN, unsigned Level ){
+        const unsigned Shift = (levels - 1 - Level) * bits;
+        const uint64_t Idx = (Shift >= 64) ? 0 : (VPN >> Shift);
+        return (Level == 0) ? (Idx & ((1ull << rootBits) - 1)) : (Idx & levelMask);
+      }
+
+      /// RevPageTable: recursively free a node and its children
+      void FreeNode( void **Node, unsigned Level );
+
+      /// RevPageTable: recursively visit the valid leaf entries below a node
+      template <typename F>
+      void ForEachNode( void **Node, unsigned Level, uint64_t Prefix, F &Fn ){
+        if( !Node )
+          return ;
+        if( Level == levels-1 ){
+          RevPTE *Leaf = (RevPTE *)(Node);
+          for( uint64_t i=0; i<(1ull << bits); i++ ){
+            if( Leaf[i].Flags & PTE_VALID )
+              Fn((Prefix << bits) | i, Leaf[i]);
+          }
+          return ;
+        }
+        const uint64_t Entries = (Level == 0) ? (1ull << rootBits) : (1ull << bits);
+        for( uint64_t i=0; i<Entries; i++ ){
+          ForEachNode((void **)(Node[i]), Level+1, (Prefix << bits) | i, Fn);
+        }
+      }
+    }; // class RevPageTable
+  } // namespace RevCPU
+} // namespace SST
+
+#endif // _SST_REVCPU_REVPAGETABLE_H_
+
+// EOF
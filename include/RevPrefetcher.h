@@ -42,6 +42,12 @@ public:
   /// RevPrefetcher: determines in the target instruction is already cached in a stream
   bool IsAvail(uint64_t Addr);
 
+  /// RevPrefetcher: write the stream buffers to a checkpoint
+  void Checkpoint(RevCheckpoint &C);
+
+  /// RevPrefetcher: restore the stream buffers from a checkpoint
+  void Restore(RevCheckpoint &C);
+
 private:
   RevMem *mem;                                ///< RevMem object
   unsigned depth;                             ///< Depth of each prefetcher stream
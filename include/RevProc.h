@@ -115,6 +115,15 @@ namespace SST{
 
       RevMem& GetMem(){ return *mem; }
 
+      /// RevProc: Determines whether the pipeline is drained so that the core can be checkpointed
+      bool IsQuiescent(){ return Pipeline.empty() && !PendingCtxSwitch; }
+
+      /// RevProc: Write the architectural state, ThreadTable, prefetcher and statistics to a checkpoint
+      void Checkpoint(RevCheckpoint &C);
+
+      /// RevProc: Restore the state written by Checkpoint
+      void Restore(RevCheckpoint &C);
+
       /// RevProc: Add a RevThreadCtx to the Proc's ThreadTable
       bool AddCtx(RevThreadCtx& Ctx); 
   
@@ -0,0 +1,121 @@
+//
+// _RevTLB_h_
+//
+// Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+//
+// See LICENSE in the top level directory for licensing details
+//
+
+#ifndef _SST_REVCPU_REVTLB_H_
+#define _SST_REVCPU_REVTLB_H_
+
+// -- C++ Headers
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+// -- SST Headers
+#include <sst/core/sst_config.h>
+#include <sst/core/output.h>
+
+#ifndef _INVALID_ADDR_
+#define _INVALID_ADDR_ 0xFFFFFFFFFFFFFFFF
+#endif
+
+namespace SST {
+  namespace RevCPU {
+
+    // ----------------------------------------
+    // RevTLB
+    // ----------------------------------------
+    // Set-associative translation lookaside buffer indexed by
+    // virtual page number.  Each set carries a single word of
+    // MRU bits that implements bit-PLRU replacement.
+    class RevTLB {
+    public:
+      /// RevTLB: constructor
+      RevTLB( unsigned Entries, unsigned Ways, SST::Output *Output );
+
+      /// RevTLB: destructor
+      ~RevTLB();
+
+      /// RevTLB: retrieve the physical page number for the target virtual page; _INVALID_ADDR_ on a miss
+      uint64_t Lookup( uint64_t VPN ){
+        const unsigned Base = (unsigned)(VPN & setMask) * ways;
+        for( unsigned w=0; w<ways; w++ ){
+          if( Tags[Base+w] == VPN ){
+            hits++;
+            Touch(Base, w);
+            return PPNs[Base+w];
+          }
+        }
+        misses++;
+        return _INVALID_ADDR_;
+      }
+
+      /// RevTLB: insert a new translation; returns the evicted VPN or _INVALID_ADDR_
+      uint64_t Insert( uint64_t VPN, uint64_t PPN );
+
+      /// RevTLB: retrieve the slot (set*ways+way) holding the target virtual page; GetEntries() if absent
+      unsigned Find( uint64_t VPN ){
+        const unsigned Base = (unsigned)(VPN & setMask) * ways;
+        for( unsigned w=0; w<ways; w++ ){
+          if( Tags[Base+w] == VPN )
+            return Base+w;
+        }
+        return sets * ways;
+      }
+
+      /// RevTLB: record a hit on the target slot that was served by a host-side translation cache
+      void RecordHit( unsigned Slot ){
+        hits++;
+        Touch(Slot - (Slot % ways), Slot % ways);
+      }
+
+      /// RevTLB: invalidate every entry
+      void Flush();
+
+      /// RevTLB: retrieve the number of entries
+      unsigned GetEntries() { return sets * ways; }
+
+      /// RevTLB: retrieve the number of ways
+      unsigned GetWays() { return ways; }
+
+      /// RevTLB: retrieve the number of sets
+      unsigned GetSets() { return sets; }
+
+      /// RevTLB: retrieve the number of hits
+      uint64_t GetHits() { return hits; }
+
+      /// RevTLB: retrieve the number of misses
+      uint64_t GetMisses() { return misses; }
+
+    private:
+      unsigned sets;                ///< RevTLB: number of sets
+      unsigned ways;                ///< RevTLB: number of ways per set
+      uint64_t setMask;             ///< RevTLB: mask used to derive the set index
+      uint64_t fullMask;            ///< RevTLB: MRU mask with every way set
+      uint64_t hits;                ///< RevTLB: number of hits
+      uint64_t misses;              ///< RevTLB: number of misses
+      SST::Output *output;          ///< RevTLB: output handler
+
+      std::vector<uint64_t> Tags;   ///< RevTLB: virtual page numbers [set*ways+way]
+      std::vector<uint64_t> PPNs;   ///< RevTLB: physical page numbers [set*ways+way]
+      std::vector<uint64_t> MRU;    ///< RevTLB: per-set MRU bits
+
+      /// RevTLB: mark the target way as most recently used
+      void Touch( unsigned Base, unsigned Way ){
+        uint64_t &Bits = MRU[Base/ways];
+        Bits |= (1ull << Way);
+        if( Bits == fullMask )
+          Bits = (1ull << Way);
+      }
+    }; // class RevTLB
+  } // namespace RevCPU
+} // namespace SST
+
+#endif // _SST_REVCPU_REVTLB_H_
+
+// EOF
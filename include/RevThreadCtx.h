@@ -69,6 +69,9 @@ public:
   bool isWaiting(){ return (State == ThreadState::Waiting); }        /// RevThreadCtx: Checks if Ctx's ThreadState is Running
   bool isDead(){ return (State == ThreadState::Dead); }              /// RevThreadCtx: Checks if Ctx's ThreadState is Running
 
+  void Checkpoint(RevCheckpoint& C);                                 /// RevThreadCtx: Writes the Ctx to a checkpoint
+  void Restore(RevCheckpoint& C);                                    /// RevThreadCtx: Restores the Ctx from a checkpoint
+
 };
 
 
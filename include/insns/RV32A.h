@@ -33,7 +33,7 @@ namespace SST{
           R->RV64_PC += Inst.instSize;
         }
         // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
+        R->cost += M->AccessCost(F->GetMinCost(),F->GetMaxCost());
         return true;
       }
 
@@ -48,6 +48,7 @@ namespace SST{
           }else{
             // failed to clear the reservation
             R->RV32[Inst.rd] = 1;
+            R->RV32_PC += Inst.instSize;
             return true;
           }
         }else{
@@ -60,200 +61,69 @@ namespace SST{
           }else{
             // failed to clear the reservation
             R->RV64[Inst.rd] = 1;
+            R->RV64_PC += Inst.instSize;
             return true;
           }
         }
       }
 
-      static bool amoswapw(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
+      /// RV32A: perform a 32-bit AMO as a single atomic read-modify-write
+      static bool amow(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst,
+                       RevCPU::RevFlag Op) {
         if( F->IsRV32() ){
-          SEXT(R->RV32[Inst.rd],M->ReadU32( (uint64_t)(R->RV32[Inst.rs1])), 32 );
-          M->WriteU32((uint64_t)(R->RV32[Inst.rs1]), (uint32_t)(R->RV32[Inst.rs2]));
+          uint32_t Val = (uint32_t)(R->RV32[Inst.rs2]);
+          M->AMOVal((uint64_t)(R->RV32[Inst.rs1]), &Val,
+                    (uint32_t *)(&R->RV32[Inst.rd]),
+                    REVMEM_FLAGS(Op));
           R->RV32_PC += Inst.instSize;
         }else{
-          SEXT(R->RV64[Inst.rd],M->ReadU32( (uint64_t)(R->RV64[Inst.rs1])), 64 );
-          M->WriteU32((uint64_t)(R->RV64[Inst.rs1]), (uint32_t)(R->RV64[Inst.rs2]));
+          // the prior value is sign extended into rd
+          uint32_t Val = (uint32_t)(R->RV64[Inst.rs2]);
+          M->AMOVal((uint64_t)(R->RV64[Inst.rs1]), &Val,
+                    (uint32_t *)(&R->RV64[Inst.rd]),
+                    REVMEM_FLAGS((uint32_t)(Op) |
+                                 (uint32_t)(RevCPU::RevFlag::F_SEXT64)));
           R->RV64_PC += Inst.instSize;
         }
         // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
+        R->cost += M->AccessCost(F->GetMinCost(),F->GetMaxCost());
         return true;
       }
 
+      static bool amoswapw(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
+        return amow(F, R, M, Inst, RevCPU::RevFlag::F_AMOSWAP);
+      }
+
       static bool amoaddw(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        if( F->IsRV32() ){
-          M->WriteU32((uint64_t)(R->RV32[Inst.rs1]),
-                      dt_u32((int32_t)(td_u32(R->RV32[Inst.rd],32))+
-                             (int32_t)(td_u32(R->RV32[Inst.rs2],32)),32));
-          R->RV32_PC += Inst.instSize;
-        }else{
-          M->WriteU32((uint64_t)(R->RV64[Inst.rs1]),
-                      dt_u32((int32_t)(td_u32(R->RV64[Inst.rd],32))+
-                             (int32_t)(td_u32(R->RV64[Inst.rs2],32)),32));
-          R->RV64_PC += Inst.instSize;
-        }
-        // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
-        return true;
+        return amow(F, R, M, Inst, RevCPU::RevFlag::F_AMOADD);
       }
 
       static bool amoxorw(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        if( F->IsRV32() ){
-          M->WriteU32((uint64_t)(R->RV32[Inst.rs1]),
-                      dt_u32((int32_t)(td_u32(R->RV32[Inst.rd],32))^
-                             (int32_t)(td_u32(R->RV32[Inst.rs2],32)),32));
-          R->RV32_PC += Inst.instSize;
-        }else{
-          M->WriteU32((uint64_t)(R->RV64[Inst.rs1]),
-                      dt_u32((int32_t)(td_u32(R->RV64[Inst.rd],32))^
-                             (int32_t)(td_u32(R->RV64[Inst.rs2],32)),32));
-          R->RV64_PC += Inst.instSize;
-        }
-        // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
-        return true;
+        return amow(F, R, M, Inst, RevCPU::RevFlag::F_AMOXOR);
       }
 
       static bool amoandw(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        if( F->IsRV32() ){
-          M->WriteU32((uint64_t)(R->RV32[Inst.rs1]),
-                      dt_u32((int32_t)(td_u32(R->RV32[Inst.rd],32))&
-                             (int32_t)(td_u32(R->RV32[Inst.rs2],32)),32));
-          R->RV32_PC += Inst.instSize;
-        }else{
-          M->WriteU32((uint64_t)(R->RV64[Inst.rs1]),
-                      dt_u32((int32_t)(td_u32(R->RV64[Inst.rd],32))&
-                             (int32_t)(td_u32(R->RV64[Inst.rs2],32)),32));
-          R->RV64_PC += Inst.instSize;
-        }
-        // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
-        return true;
+        return amow(F, R, M, Inst, RevCPU::RevFlag::F_AMOAND);
       }
 
       static bool amoorw(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        if( F->IsRV32() ){
-          M->WriteU32((uint64_t)(R->RV32[Inst.rs1]),
-                      dt_u32((int32_t)(td_u32(R->RV32[Inst.rd],32))|
-                             (int32_t)(td_u32(R->RV32[Inst.rs2],32)),32));
-          R->RV32_PC += Inst.instSize;
-        }else{
-          M->WriteU32((uint64_t)(R->RV64[Inst.rs1]),
-                      dt_u32((int32_t)(td_u32(R->RV64[Inst.rd],32))|
-                             (int32_t)(td_u32(R->RV64[Inst.rs2],32)),32));
-          R->RV64_PC += Inst.instSize;
-        }
-        // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
-        return true;
+        return amow(F, R, M, Inst, RevCPU::RevFlag::F_AMOOR);
       }
 
       static bool amominw(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        if( F->IsRV32() ){
-          SEXT(R->RV32[Inst.rd],M->ReadU32( (uint64_t)(R->RV32[Inst.rs1])), 32 );
-          if( (int32_t)(td_u32(R->RV32[Inst.rd],32)) < (int32_t)(td_u32(R->RV32[Inst.rs2],32)) ){
-            M->WriteU32((uint64_t)(R->RV32[Inst.rs1]),
-                        (uint32_t)(R->RV32[Inst.rd]));
-          }else{
-            M->WriteU32((uint64_t)(R->RV32[Inst.rs1]),
-                        (uint32_t)(R->RV32[Inst.rs2]));
-          }
-          R->RV32_PC += Inst.instSize;
-        }else{
-          SEXT(R->RV64[Inst.rd],M->ReadU32( (uint64_t)(R->RV64[Inst.rs1])), 64 );
-          if( (int32_t)(td_u32(R->RV64[Inst.rd],32)) < (int32_t)(td_u32(R->RV64[Inst.rs2],32)) ){
-            M->WriteU32((uint64_t)(R->RV64[Inst.rs1]),
-                        (uint32_t)(R->RV64[Inst.rd]));
-          }else{
-            M->WriteU32((uint64_t)(R->RV64[Inst.rs1]),
-                        (uint32_t)(R->RV64[Inst.rs2]));
-          }
-          R->RV64_PC += Inst.instSize;
-        }
-        // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
-        return true;
+        return amow(F, R, M, Inst, RevCPU::RevFlag::F_AMOMIN);
       }
 
       static bool amomaxw(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        if( F->IsRV32() ){
-          SEXT(R->RV32[Inst.rd],M->ReadU32( (uint64_t)(R->RV32[Inst.rs1])), 32 );
-          if( (int32_t)(td_u32(R->RV32[Inst.rd],32)) > (int32_t)(td_u32(R->RV32[Inst.rs2],32)) ){
-            M->WriteU32((uint64_t)(R->RV32[Inst.rs1]),
-                        (uint32_t)(R->RV32[Inst.rd]));
-          }else{
-            M->WriteU32((uint64_t)(R->RV32[Inst.rs1]),
-                        (uint32_t)(R->RV32[Inst.rs2]));
-          }
-          R->RV32_PC += Inst.instSize;
-        }else{
-          SEXT(R->RV64[Inst.rd],M->ReadU32( (uint64_t)(R->RV64[Inst.rs1])), 64 );
-          if( (int32_t)(td_u32(R->RV64[Inst.rd],32)) > (int32_t)(td_u32(R->RV64[Inst.rs2],32)) ){
-            M->WriteU32((uint64_t)(R->RV64[Inst.rs1]),
-                        (uint32_t)(R->RV64[Inst.rd]));
-          }else{
-            M->WriteU32((uint64_t)(R->RV64[Inst.rs1]),
-                        (uint32_t)(R->RV64[Inst.rs2]));
-          }
-          R->RV64_PC += Inst.instSize;
-        }
-        // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
-        return true;
+        return amow(F, R, M, Inst, RevCPU::RevFlag::F_AMOMAX);
       }
 
       static bool amominuw(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        if( F->IsRV32() ){
-          SEXT(R->RV32[Inst.rd],M->ReadU32( (uint64_t)(R->RV32[Inst.rs1])), 32 );
-          if( (uint32_t)(R->RV32[Inst.rd]) < (uint32_t)(R->RV32[Inst.rs2]) ){
-            M->WriteU32((uint64_t)(R->RV32[Inst.rs1]),
-                        (uint32_t)(R->RV32[Inst.rd]));
-          }else{
-            M->WriteU32((uint64_t)(R->RV32[Inst.rs1]),
-                        (uint32_t)(R->RV32[Inst.rs2]));
-          }
-          R->RV32_PC += Inst.instSize;
-        }else{
-          SEXT(R->RV64[Inst.rd],M->ReadU32( (uint64_t)(R->RV64[Inst.rs1])), 64 );
-          if( (uint32_t)(R->RV64[Inst.rd]) < (uint32_t)(R->RV64[Inst.rs2]) ){
-            M->WriteU32((uint64_t)(R->RV64[Inst.rs1]),
-                        (uint32_t)(R->RV64[Inst.rd]));
-          }else{
-            M->WriteU32((uint64_t)(R->RV64[Inst.rs1]),
-                        (uint32_t)(R->RV64[Inst.rs2]));
-          }
-          R->RV64_PC += Inst.instSize;
-        }
-        // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
-        return true;
+        return amow(F, R, M, Inst, RevCPU::RevFlag::F_AMOMINU);
       }
 
       static bool amomaxuw(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        if( F->IsRV32() ){
-          SEXT(R->RV32[Inst.rd],M->ReadU32( (uint64_t)(R->RV32[Inst.rs1])), 32 );
-          if( (uint32_t)(R->RV32[Inst.rd]) > (uint32_t)(R->RV32[Inst.rs2]) ){
-            M->WriteU32((uint64_t)(R->RV32[Inst.rs1]),
-                        (uint32_t)(R->RV32[Inst.rd]));
-          }else{
-            M->WriteU32((uint64_t)(R->RV32[Inst.rs1]),
-                        (uint32_t)(R->RV32[Inst.rs2]));
-          }
-          R->RV32_PC += Inst.instSize;
-        }else{
-          SEXT(R->RV64[Inst.rd],M->ReadU32( (uint64_t)(R->RV64[Inst.rs1])), 64 );
-          if( (uint32_t)(R->RV64[Inst.rd]) > (uint32_t)(R->RV64[Inst.rs2]) ){
-            M->WriteU32((uint64_t)(R->RV64[Inst.rs1]),
-                        (uint32_t)(R->RV64[Inst.rd]));
-          }else{
-            M->WriteU32((uint64_t)(R->RV64[Inst.rs1]),
-                        (uint32_t)(R->RV64[Inst.rs2]));
-          }
-          R->RV64_PC += Inst.instSize;
-        }
-        // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
-        return true;
+        return amow(F, R, M, Inst, RevCPU::RevFlag::F_AMOMAXU);
       }
 
       // ----------------------------------------------------------------------
@@ -87,7 +87,7 @@ namespace SST{
             R->RV64_PC += Inst.instSize;
           }
         }
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
+        R->cost += M->AccessCost(F->GetMinCost(),F->GetMaxCost());
         return true;
       }
 
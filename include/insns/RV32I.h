@@ -460,7 +460,7 @@ namespace SST{
           R->RV64_PC += Inst.instSize;
         }
         // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
+        R->cost += M->AccessCost(F->GetMinCost(),F->GetMaxCost());
         return true;
       }
 
@@ -483,7 +483,7 @@ namespace SST{
           R->RV64_PC += Inst.instSize;
         }
         // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
+        R->cost += M->AccessCost(F->GetMinCost(),F->GetMaxCost());
         return true;
       }
 
@@ -506,7 +506,7 @@ namespace SST{
           R->RV64_PC += Inst.instSize;
         }
         // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
+        R->cost += M->AccessCost(F->GetMinCost(),F->GetMaxCost());
         return true;
       }
 
@@ -529,7 +529,7 @@ namespace SST{
           R->RV64_PC += Inst.instSize;
         }
         // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
+        R->cost += M->AccessCost(F->GetMinCost(),F->GetMaxCost());
         return true;
       }
 
@@ -552,7 +552,7 @@ namespace SST{
           R->RV64_PC += Inst.instSize;
         }
         // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
+        R->cost += M->AccessCost(F->GetMinCost(),F->GetMaxCost());
         return true;
       }
 
@@ -33,127 +33,63 @@ namespace SST{
           // successfully cleared the reservation
           M->WriteU64( (uint64_t)(R->RV64[Inst.rs1]), (uint64_t)(R->RV64[Inst.rs2]) );
           R->RV64[Inst.rd] = 0;
+          R->RV64_PC += Inst.instSize;
           return true;
         }else{
           // failed to clear the reservation
           R->RV64[Inst.rd] = 1;
+          R->RV64_PC += Inst.instSize;
           return true;
         }
       }
 
-      static bool amoswapd(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        SEXT(R->RV64[Inst.rd],M->ReadU32( (uint64_t)(R->RV64[Inst.rs1])), 64 );
-        M->WriteU64((uint64_t)(R->RV64[Inst.rs1]), (uint64_t)(R->RV64[Inst.rs2]));
+      /// RV64A: perform a 64-bit AMO as a single atomic read-modify-write
+      static bool amod(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst,
+                       RevCPU::RevFlag Op) {
+        uint64_t Val = R->RV64[Inst.rs2];
+        M->AMOVal((uint64_t)(R->RV64[Inst.rs1]), &Val,
+                  &R->RV64[Inst.rd],
+                  REVMEM_FLAGS(Op));
         R->RV64_PC += Inst.instSize;
         // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
+        R->cost += M->AccessCost(F->GetMinCost(),F->GetMaxCost());
         return true;
       }
 
+      static bool amoswapd(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
+        return amod(F, R, M, Inst, RevCPU::RevFlag::F_AMOSWAP);
+      }
+
       static bool amoaddd(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        SEXT(R->RV64[Inst.rd],M->ReadU32( (uint64_t)(R->RV64[Inst.rs1])), 64 );
-        M->WriteU64((uint64_t)(R->RV64[Inst.rs1]),
-                    dt_u64((int64_t)(td_u64(R->RV64[Inst.rd],64))+
-                           (int64_t)(td_u64(R->RV64[Inst.rs2],64)),64));
-        R->RV64_PC += Inst.instSize;
-        // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
-        return true;
+        return amod(F, R, M, Inst, RevCPU::RevFlag::F_AMOADD);
       }
 
       static bool amoxord(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        SEXT(R->RV64[Inst.rd],M->ReadU32( (uint64_t)(R->RV64[Inst.rs1])), 64 );
-        M->WriteU64((uint64_t)(R->RV64[Inst.rs1]),
-                    dt_u64((int64_t)(td_u64(R->RV64[Inst.rd],64))^
-                           (int64_t)(td_u64(R->RV64[Inst.rs2],64)),64));
-        R->RV64_PC += Inst.instSize;
-        // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
-        return true;
+        return amod(F, R, M, Inst, RevCPU::RevFlag::F_AMOXOR);
       }
 
       static bool amoandd(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        SEXT(R->RV64[Inst.rd],M->ReadU32( (uint64_t)(R->RV64[Inst.rs1])), 64 );
-        M->WriteU64((uint64_t)(R->RV64[Inst.rs1]),
-                    dt_u64((int64_t)(td_u64(R->RV64[Inst.rd],64))&
-                           (int64_t)(td_u64(R->RV64[Inst.rs2],64)),64));
-        R->RV64_PC += Inst.instSize;
-        // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
-        return true;
+        return amod(F, R, M, Inst, RevCPU::RevFlag::F_AMOAND);
       }
 
       static bool amoord(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        SEXT(R->RV64[Inst.rd],M->ReadU32( (uint64_t)(R->RV64[Inst.rs1])), 64 );
-        M->WriteU64((uint64_t)(R->RV64[Inst.rs1]),
-                    dt_u64((int64_t)(td_u64(R->RV64[Inst.rd],64))|
-                           (int64_t)(td_u64(R->RV64[Inst.rs2],64)),64));
-        R->RV64_PC += Inst.instSize;
-        // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
-        return true;
+        return amod(F, R, M, Inst, RevCPU::RevFlag::F_AMOOR);
       }
 
       static bool amomind(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        SEXT(R->RV64[Inst.rd],M->ReadU32( (uint64_t)(R->RV64[Inst.rs1])), 64 );
-        if( (int64_t)(td_u64(R->RV64[Inst.rd],64)) <
-            (int64_t)(td_u64(R->RV64[Inst.rs2],64)) ){
-          M->WriteU64((uint64_t)(R->RV64[Inst.rs1]),
-                      (uint64_t)(R->RV64[Inst.rd]));
-        }else{
-          M->WriteU64((uint64_t)(R->RV64[Inst.rs1]),
-                      (uint64_t)(R->RV64[Inst.rs2]));
-        }
-        R->RV64_PC += Inst.instSize;
-        // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
-        return true;
+        return amod(F, R, M, Inst, RevCPU::RevFlag::F_AMOMIN);
       }
 
       static bool amomaxd(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        SEXT(R->RV64[Inst.rd],M->ReadU32( (uint64_t)(R->RV64[Inst.rs1])), 64 );
-        if( (int64_t)(td_u64(R->RV64[Inst.rd],64)) >
-            (int64_t)(td_u64(R->RV64[Inst.rs2],64)) ){
-          M->WriteU64((uint64_t)(R->RV64[Inst.rs1]),
-                      (uint64_t)(R->RV64[Inst.rd]));
-        }else{
-          M->WriteU64((uint64_t)(R->RV64[Inst.rs1]),
-                      (uint64_t)(R->RV64[Inst.rs2]));
-        }
-        R->RV64_PC += Inst.instSize;
-        // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
-        return true;
+        return amod(F, R, M, Inst, RevCPU::RevFlag::F_AMOMAX);
       }
 
       static bool amominud(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        SEXT(R->RV64[Inst.rd],M->ReadU32( (uint64_t)(R->RV64[Inst.rs1])), 64 );
-        if( (uint64_t)(R->RV64[Inst.rd]) < (uint64_t)(R->RV64[Inst.rs2]) ){
-          M->WriteU64((uint64_t)(R->RV64[Inst.rs1]),
-                      (uint64_t)(R->RV64[Inst.rd]));
-        }else{
-          M->WriteU64((uint64_t)(R->RV64[Inst.rs1]),
-                      (uint64_t)(R->RV64[Inst.rs2]));
-        }
-        R->RV64_PC += Inst.instSize;
-        // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
-        return true;
+        return amod(F, R, M, Inst, RevCPU::RevFlag::F_AMOMINU);
       }
 
       static bool amomaxud(RevFeature *F, RevRegFile *R,RevMem *M,RevInst Inst) {
-        SEXT(R->RV64[Inst.rd],M->ReadU32( (uint64_t)(R->RV64[Inst.rs1])), 64 );
-        if( (uint64_t)(R->RV64[Inst.rd]) > (uint64_t)(R->RV64[Inst.rs2]) ){
-          M->WriteU64((uint64_t)(R->RV64[Inst.rs1]),
-                      (uint64_t)(R->RV64[Inst.rd]));
-        }else{
-          M->WriteU64((uint64_t)(R->RV64[Inst.rs1]),
-                      (uint64_t)(R->RV64[Inst.rs2]));
-        }
-        R->RV64_PC += Inst.instSize;
-        // update the cost
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
-        return true;
+        return amod(F, R, M, Inst, RevCPU::RevFlag::F_AMOMAXU);
       }
 
       // ----------------------------------------------------------------------
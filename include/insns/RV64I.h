@@ -98,7 +98,7 @@ namespace SST{
         R->RV64[Inst.rd] = 0x00ULL;
         R->RV64[Inst.rd] |= (uint64_t)(val);
         //ZEXT64(R->RV64[Inst.rd], (uint64_t)val, 64);
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
+        R->cost += M->AccessCost(F->GetMinCost(),F->GetMaxCost());
         R->RV64_PC += Inst.instSize;
         return true;
       }
@@ -108,7 +108,7 @@ namespace SST{
         M->ReadVal((uint64_t)(R->RV64[Inst.rs1]+(int32_t)(td_u32(Inst.imm,12))),
                     &R->RV64[Inst.rd],
                     REVMEM_FLAGS(0x00));
-        R->cost += M->RandCost(F->GetMinCost(),F->GetMaxCost());
+        R->cost += M->AccessCost(F->GetMinCost(),F->GetMaxCost());
         R->RV64_PC += Inst.instSize;
         return true;
       }
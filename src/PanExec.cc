@@ -77,6 +77,31 @@ PanExec::PanStatus PanExec::GetNextEntry(uint64_t *Addr, unsigned *Idx){
   return PanExec::QError;
 }
 
+void PanExec::Checkpoint(RevCheckpoint &C){
+  C.Section("PanExec");
+  C.Put<uint32_t>(CurEntry);
+  C.Put<uint64_t>(ExecQueue.size());
+  for( auto &E : ExecQueue ){
+    C.Put<uint32_t>(std::get<0>(E));
+    C.Put<uint32_t>((uint32_t)(std::get<1>(E)));
+    C.Put<uint64_t>(std::get<2>(E));
+  }
+}
+
+void PanExec::Restore(RevCheckpoint &C){
+  C.Section("PanExec");
+  CurEntry = C.Get<uint32_t>();
+  ExecQueue.clear();
+  const uint64_t Entries = C.Get<uint64_t>();
+  for( uint64_t i=0; i<Entries; i++ ){
+    const unsigned Idx = C.Get<uint32_t>();
+    const PanExec::PanStatus Status = (PanExec::PanStatus)(C.Get<uint32_t>());
+    ExecQueue.push_back(std::tuple<unsigned,
+                                   PanExec::PanStatus,
+                                   uint64_t>(Idx,Status,C.Get<uint64_t>()));
+  }
+}
+
 unsigned PanExec::GetNewEntry(){
   CurEntry = CurEntry+1;
   if( CurEntry >= _PANEXEC_MAX_ENTRY_ )
@@ -34,7 +34,11 @@ const char *pan_splash_msg = "\
 RevCPU::RevCPU( SST::ComponentId_t id, SST::Params& params )
   : SST::Component(id), testStage(0), PrivTag(0), address(-1), PrevAddr(_PAN_RDMA_MAILBOX_),
     EnableNIC(false), EnablePAN(false), EnablePANStats(false), EnableMemH(false),
-    ReadyForRevoke(false), Nic(nullptr), PNic(nullptr), PExec(nullptr), Ctrl(nullptr) {
+    ReadyForRevoke(false), Nic(nullptr), PNic(nullptr), PExec(nullptr), Ctrl(nullptr), Trace(nullptr),
+    EnableHeatMap(false), HeatMapInterval(0), CheckpointCycle(0), CheckpointExit(false),
+    CheckpointDone(false), Restored(false),
+    Replay(nullptr), ReplayTiming(true), ReplayMaxPending(64), ReplayHasNext(false),
+    ReplayFirstCycle(0), ReplayStartCycle(0) {
 
   const int Verbosity = params.find<int>("verbose", 0);
 
@@ -44,6 +48,9 @@ RevCPU::RevCPU( SST::ComponentId_t id, SST::Params& params )
   // Determine whether we're running the test harness
   EnablePANTest = params.find<bool>("enable_test", 0);
 
+  // Determine whether we're replaying a memory trace
+  const std::string replayFile = params.find<std::string>("replay_file", "");
+
   // Register a new clock handler
   {
     const std::string cpuClock = params.find<std::string>("clock", "1GHz");
@@ -51,6 +58,9 @@ RevCPU::RevCPU( SST::ComponentId_t id, SST::Params& params )
       timeConverter  = registerClock(cpuClock,
                                      new SST::Clock::Handler<RevCPU>(this,&RevCPU::clockTickPANTest));
       testIters = params.find<unsigned>("testIters", 255);
+    }else if( !replayFile.empty() ){
+      timeConverter  = registerClock(cpuClock,
+                                     new SST::Clock::Handler<RevCPU>(this,&RevCPU::clockTickReplay));
     }else{
       timeConverter  = registerClock(cpuClock,
                                      new SST::Clock::Handler<RevCPU>(this,&RevCPU::clockTick));
@@ -111,6 +121,11 @@ RevCPU::RevCPU( SST::ComponentId_t id, SST::Params& params )
     params.find_array<std::string>("prefetchDepth",prefetchDepths);
     if( !Opts->InitPrefetchDepth( prefetchDepths) )
       output.fatal(CALL_INFO, -1, "Error: failed to initalize the prefetch depth\n" );
+
+    std::vector<std::string> memRegions;
+    params.find_array<std::string>("memRegions", memRegions);
+    if( !Opts->InitMemRegions( memRegions ) )
+      output.fatal(CALL_INFO, -1, "Error: failed to initialize the memory regions\n" );
   }
 
   // See if we should load the network interface controller
@@ -195,6 +210,8 @@ RevCPU::RevCPU( SST::ComponentId_t id, SST::Params& params )
     Mem = new RevMem( memSize, Opts,  &output );
     if( !Mem )
       output.fatal(CALL_INFO, -1, "Error: failed to initialize the memory object\n" );
+    if( params.find<bool>("enable_hugepages", 0) )
+      Mem->EnableHugePages();
   }else{
     if( EnablePAN )
       output.fatal(CALL_INFO, -1, "Error: PAN does not currently support memHierarchy\n");
@@ -202,6 +219,7 @@ RevCPU::RevCPU( SST::ComponentId_t id, SST::Params& params )
     Ctrl = loadUserSubComponent<RevMemCtrl>("memory");
     if( !Ctrl )
       output.fatal(CALL_INFO, -1, "Error : failed to inintialize the memory controller subcomponent\n");
+    Ctrl->setNumCores(numCores);
 
     Mem = new RevMem( memSize, Opts, Ctrl, &output );
     if( !Mem )
@@ -211,16 +229,87 @@ RevCPU::RevCPU( SST::ComponentId_t id, SST::Params& params )
       output.verbose(CALL_INFO, 1, 0, "Warning: memory faults cannot be enabled with memHierarchy support\n");
   }
 
-  // Set TLB Size
-  const unsigned long tlbSize = params.find<unsigned long>("tlbSize", 512);
-  Mem->SetTLBSize(tlbSize);
+  // Set the page size and the per-core TLB geometry
+  const uint64_t pageSize = params.find<uint64_t>("pageSize", 262144);
+  Mem->SetPageSize(pageSize);
+  const unsigned tlbSize = params.find<unsigned>("tlbSize", 512);
+  const unsigned tlbWays = params.find<unsigned>("tlbWays", 8);
+  Mem->SetTLBSize(tlbSize, tlbWays);
+
+  // Setup the memory access trace
+  const std::string traceFile = params.find<std::string>("trace_file", "");
+  if( !traceFile.empty() ){
+    Trace = new RevMemTrace(traceFile, params.find<uint64_t>("trace_buffer", 1048576), &output);
+    Trace->SetAddrRange(params.find<uint64_t>("trace_min_addr", 0),
+                        params.find<uint64_t>("trace_max_addr", 0xFFFFFFFFFFFFFFFFull));
+    Trace->SetCycleWindow(params.find<uint64_t>("trace_start", 0),
+                          params.find<uint64_t>("trace_stop", 0xFFFFFFFFFFFFFFFFull));
+  }
+
+  // Register the region-specific memory latencies
+  for( const RevMemRegion &R : Opts->GetMemRegions() ){
+    Mem->AddMemRegion(R);
+  }
+
+  // Replay skips the loader and the cores; accesses are issued from the trace
+  if( !replayFile.empty() ){
+    if( EnablePAN || EnablePANTest )
+      output.fatal(CALL_INFO, -1, "Error: trace replay does not support PAN\n");
+    Replay = new RevMemTraceReader(replayFile, &output);
+    ReplayTiming = params.find<bool>("replay_timing", 1);
+    ReplayMaxPending = params.find<uint64_t>("replay_max_pending", 64);
+    ReplayHasNext = Replay->Next(ReplayNext);
+    ReplayBuf.resize(_REV_REPLAY_BUF_);
+    ReplayFirstCycle = ReplayHasNext ? ReplayNext.Cycle : 0;
+    ReplayStartCycle = _INVALID_ADDR_;
+    Loader = nullptr;
+    Enabled = nullptr;
+    output.verbose(CALL_INFO, 1, 0, "Replaying memory trace %s\n", replayFile.c_str());
+  }else{
+    // Load the binary into memory
+    Loader = new RevLoader( Exe, Args, Mem, &output );
+    if( !Loader ){
+      output.fatal(CALL_INFO, -1, "Error: failed to initialize the RISC-V loader\n" );
+    }
+  }
+
+  // Attach the memory trace once the binary is resident
+  if( Trace )
+    Mem->SetTrace(Trace);
 
-  // Load the binary into memory
-  Loader = new RevLoader( Exe, Args, Mem, &output );
-  if( !Loader ){
-    output.fatal(CALL_INFO, -1, "Error: failed to initialize the RISC-V loader\n" );
+  // Setup the page heat map once the binary is resident
+  const std::string heatFile = params.find<std::string>("heatmap_file", "");
+  if( !heatFile.empty() ){
+    EnableHeatMap = true;
+    HeatMapInterval = params.find<uint64_t>("heatmap_interval", 0);
+    Mem->EnableHeatMap(heatFile, params.find<unsigned>("heatmap_top", 16));
   }
 
+  // Setup the cache timing model once the binary is resident
+  if( params.find<bool>("enable_cache", 0) ){
+    if( EnableMemH ){
+      output.verbose(CALL_INFO, 1, 0, "Warning: the cache model is ignored when memHierarchy is enabled\n");
+    }else{
+      RevCacheConfig L1, L2;
+      L1.LineSize     = L2.LineSize = params.find<unsigned>("cacheLineSize", 64);
+      L1.Size         = params.find<uint64_t>("l1Size", 32768);
+      L1.Ways         = params.find<unsigned>("l1Ways", 8);
+      L1.HitLatency   = params.find<unsigned>("l1HitLatency", 1);
+      L1.MissLatency  = params.find<unsigned>("l1MissLatency", 1);
+      L1.Shared       = params.find<bool>("l1Shared", 0);
+      L2.Size         = params.find<uint64_t>("l2Size", 262144);
+      L2.Ways         = params.find<unsigned>("l2Ways", 8);
+      L2.HitLatency   = params.find<unsigned>("l2HitLatency", 10);
+      L2.MissLatency  = params.find<unsigned>("l2MissLatency", 2);
+      L2.Shared       = params.find<bool>("l2Shared", 1);
+      Mem->EnableCacheModel(L1, L2);
+    }
+  }
+
+  // Replay does not instantiate any cores
+  if( Replay )
+    return ;
+
   // Create the processor objects
   Procs.reserve(Procs.size() + numCores);
   for( unsigned i=0; i<numCores; i++ ){
@@ -239,6 +328,14 @@ RevCPU::RevCPU( SST::ComponentId_t id, SST::Params& params )
   FloatsExec.reserve(FloatsExec.size() + numCores);
   TLBHitsPerCore.reserve(TLBHitsPerCore.size() + numCores);
   TLBMissesPerCore.reserve(TLBMissesPerCore.size() + numCores);
+  SCAttemptsPerCore.reserve(SCAttemptsPerCore.size() + numCores);
+  SCFailuresPerCore.reserve(SCFailuresPerCore.size() + numCores);
+  L1HitsPerCore.reserve(L1HitsPerCore.size() + numCores);
+  L1MissesPerCore.reserve(L1MissesPerCore.size() + numCores);
+  L2HitsPerCore.reserve(L2HitsPerCore.size() + numCores);
+  L2MissesPerCore.reserve(L2MissesPerCore.size() + numCores);
+  RegionAccessesPerCore.reserve(RegionAccessesPerCore.size() + numCores);
+  RegionStallsPerCore.reserve(RegionStallsPerCore.size() + numCores);
 
   for(int s = 0; s < numCores; s++){
     TotalCycles.push_back(registerStatistic<uint64_t>("TotalCycles", "core_" + std::to_string(s)));
@@ -252,6 +349,14 @@ RevCPU::RevCPU( SST::ComponentId_t id, SST::Params& params )
     FloatsExec.push_back( registerStatistic<uint64_t>("FloatsExec", "core_" + std::to_string(s)));
     TLBHitsPerCore.push_back( registerStatistic<uint64_t>("TLBHitsPerCore", "core_" + std::to_string(s)));
     TLBMissesPerCore.push_back( registerStatistic<uint64_t>("TLBMissesPerCore", "core_" + std::to_string(s)));
+    SCAttemptsPerCore.push_back( registerStatistic<uint64_t>("SCAttemptsPerCore", "core_" + std::to_string(s)));
+    SCFailuresPerCore.push_back( registerStatistic<uint64_t>("SCFailuresPerCore", "core_" + std::to_string(s)));
+    L1HitsPerCore.push_back( registerStatistic<uint64_t>("L1HitsPerCore", "core_" + std::to_string(s)));
+    L1MissesPerCore.push_back( registerStatistic<uint64_t>("L1MissesPerCore", "core_" + std::to_string(s)));
+    L2HitsPerCore.push_back( registerStatistic<uint64_t>("L2HitsPerCore", "core_" + std::to_string(s)));
+    L2MissesPerCore.push_back( registerStatistic<uint64_t>("L2MissesPerCore", "core_" + std::to_string(s)));
+    RegionAccessesPerCore.push_back( registerStatistic<uint64_t>("RegionAccessesPerCore", "core_" + std::to_string(s)));
+    RegionStallsPerCore.push_back( registerStatistic<uint64_t>("RegionStallsPerCore", "core_" + std::to_string(s)));
   }
 
   // setup the PAN execution contexts
@@ -271,6 +376,16 @@ RevCPU::RevCPU( SST::ComponentId_t id, SST::Params& params )
     Enabled[i] = true;
   }
 
+  // Setup checkpointing and resume from a previous checkpoint
+  CheckpointFile  = params.find<std::string>("checkpoint_file", "");
+  CheckpointCycle = params.find<uint64_t>("checkpoint_cycle", 0);
+  CheckpointExit  = params.find<bool>("checkpoint_exit", 0);
+  const std::string restoreFile = params.find<std::string>("restore_file", "");
+  if( (!CheckpointFile.empty() || !restoreFile.empty()) && (EnableMemH || EnablePANTest) )
+    output.fatal(CALL_INFO, -1, "Error: checkpoints are not supported with memHierarchy or the PAN test harness\n");
+  if( !restoreFile.empty() )
+    RestoreCheckpoint(restoreFile);
+
   {
     const unsigned Splash = params.find<bool>("splash",0);
 
@@ -309,6 +424,14 @@ RevCPU::~RevCPU(){
   // delete the memory object
   delete Mem;
 
+  // drain and close the memory trace
+  if( Trace )
+    delete Trace;
+
+  // close the replayed trace
+  if( Replay )
+    delete Replay;
+
   // delete the loader object
   if( Loader )
     delete Loader;
@@ -473,9 +596,19 @@ void RevCPU::setup(){
   if( EnableMemH ){
     Ctrl->setup();
   }
+
+  // cores that had already finished when the checkpoint was taken report their totals now
+  if( Restored ){
+    for( unsigned i=0; i<Procs.size(); i++ ){
+      if( !Enabled[i] )
+        UpdateCoreStatistics(i);
+    }
+  }
 }
 
 void RevCPU::finish(){
+  if( EnableHeatMap )
+    Mem->DumpHeatMap(true);
 }
 
 void RevCPU::init( unsigned int phase ){
@@ -2328,6 +2461,144 @@ void RevCPU::UpdateCoreStatistics(uint16_t coreNum){
   FloatsExec[coreNum]->addData(stats.floatsExec);
   TLBHitsPerCore[coreNum]->addData(stats.memStats.TLBHits);
   TLBMissesPerCore[coreNum]->addData(stats.memStats.TLBMisses);
+  SCAttemptsPerCore[coreNum]->addData(stats.memStats.SCAttempts);
+  SCFailuresPerCore[coreNum]->addData(stats.memStats.SCFailures);
+  L1HitsPerCore[coreNum]->addData(stats.memStats.L1Hits);
+  L1MissesPerCore[coreNum]->addData(stats.memStats.L1Misses);
+  L2HitsPerCore[coreNum]->addData(stats.memStats.L2Hits);
+  L2MissesPerCore[coreNum]->addData(stats.memStats.L2Misses);
+  RegionAccessesPerCore[coreNum]->addData(stats.memStats.RegionAccesses);
+  RegionStallsPerCore[coreNum]->addData(stats.memStats.RegionStalls);
+}
+
+bool RevCPU::IsQuiescent(){
+  for( unsigned i=0; i<Procs.size(); i++ ){
+    if( !Procs[i]->IsQuiescent() )
+      return false;
+  }
+  return !Mem->outstandingRqsts() && SendMB.empty() && TrackTags.empty() && ZeroRqst.empty();
+}
+
+void RevCPU::WriteCheckpoint(SST::Cycle_t currentCycle){
+  {
+    RevCheckpoint C(CheckpointFile, true, &output);
+    C.Section("RevCPU");
+    C.PutString(Exe);
+    C.Put<uint32_t>(numCores);
+    C.Put<uint64_t>(currentCycle);
+    for( unsigned i=0; i<numCores; i++ )
+      C.Put<bool>(Enabled[i]);
+    C.Put<int64_t>(EnableFaults ? FaultCntr : 0);
+    C.Put<bool>(PExec != nullptr);
+    if( PExec )
+      PExec->Checkpoint(C);
+    for( unsigned i=0; i<Procs.size(); i++ )
+      Procs[i]->Checkpoint(C);
+    // the memory image is written last so that it can be mapped in place on restore
+    Mem->Checkpoint(C);
+  }
+  CheckpointDone = true;
+  output.verbose(CALL_INFO, 1, 0, "Wrote checkpoint %s at cycle %" PRIu64 "\n",
+                 CheckpointFile.c_str(), static_cast<uint64_t>(currentCycle));
+
+  if( CheckpointExit ){
+    for( unsigned i=0; i<Procs.size(); i++ ){
+      if( Enabled[i] ){
+        UpdateCoreStatistics(i);
+        Mem->SetFetchStall(i, false);
+        Enabled[i] = false;
+      }
+    }
+  }
+}
+
+void RevCPU::RestoreCheckpoint(const std::string &File){
+  RevCheckpoint C(File, false, &output);
+  C.Section("RevCPU");
+  const std::string CkptExe = C.GetString();
+  if( CkptExe != Exe )
+    output.verbose(CALL_INFO, 1, 0, "Warning: checkpoint %s was taken from program %s; resuming it in place of %s\n",
+                   File.c_str(), CkptExe.c_str(), Exe.c_str());
+  const unsigned Cores = C.Get<uint32_t>();
+  if( Cores != numCores )
+    output.fatal(CALL_INFO, -1, "Error: checkpoint %s holds %u cores; this simulation has %u\n",
+                 File.c_str(), Cores, numCores);
+  const uint64_t Cycle = C.Get<uint64_t>();
+  for( unsigned i=0; i<numCores; i++ )
+    Enabled[i] = C.Get<bool>();
+  const int64_t Faults = C.Get<int64_t>();
+  if( EnableFaults )
+    FaultCntr = Faults;
+  if( C.Get<bool>() ){
+    if( !PExec )
+      output.fatal(CALL_INFO, -1, "Error: checkpoint %s requires a PAN execution context\n", File.c_str());
+    PExec->Restore(C);
+  }
+  for( unsigned i=0; i<Procs.size(); i++ )
+    Procs[i]->Restore(C);
+  Mem->Restore(C);
+
+  Restored = true;
+  output.verbose(CALL_INFO, 1, 0, "Resumed checkpoint %s taken at cycle %" PRIu64 "\n",
+                 File.c_str(), Cycle);
+}
+
+bool RevCPU::clockTickReplay( SST::Cycle_t currentCycle ){
+  if( ReplayStartCycle == _INVALID_ADDR_ )
+    ReplayStartCycle = currentCycle;
+  Mem->SetCycle(currentCycle);
+
+  while( ReplayHasNext ){
+    // honor the recorded issue time relative to the first record
+    if( ReplayTiming &&
+        ((ReplayNext.Cycle - ReplayFirstCycle) > (currentCycle - ReplayStartCycle)) )
+      break;
+    // otherwise issue as fast as the memory controller will accept requests
+    if( Ctrl && (Ctrl->getNumPendingRqsts() >= ReplayMaxPending) )
+      break;
+
+    const RevTraceRecord &R = ReplayNext;
+    if( ReplayBuf.size() < R.Size ){
+      // queued and in-flight reads still target the buffer; only
+      // reallocate it once they have all completed
+      if( Ctrl && (Ctrl->getNumPendingRqsts() > 0) )
+        break;
+      ReplayBuf.resize(R.Size);
+    }
+    Mem->SetActiveCore(R.Core < numCores ? R.Core : 0);
+    Mem->SetActiveHart(R.Hart, R.PC);
+
+    switch( R.Op ){
+    case RevTraceOp::READ:
+      Mem->ReadMem(R.VAddr, R.Size, ReplayBuf.data(), REVMEM_FLAGS(R.Flags));
+      break;
+    case RevTraceOp::WRITE:
+      Mem->WriteMem(R.VAddr, R.Size, ReplayBuf.data(), REVMEM_FLAGS(R.Flags));
+      break;
+    case RevTraceOp::AMO:
+      Mem->AMOMem(R.VAddr, R.Size, ReplayBuf.data(), ReplayBuf.data(), REVMEM_FLAGS(R.Flags));
+      break;
+    case RevTraceOp::FENCE:
+      Mem->FenceMem();
+      break;
+    default:
+      output.fatal(CALL_INFO, -1, "Error: unknown operation in memory trace record %" PRIu64 "\n",
+                   Replay->GetNumRecords());
+      break;
+    }
+    ReplayHasNext = Replay->Next(ReplayNext);
+  }
+
+  if( EnableHeatMap && HeatMapInterval && (currentCycle % HeatMapInterval) == 0 )
+    Mem->DumpHeatMap(false);
+
+  if( ReplayHasNext || (Ctrl && Ctrl->outstandingRqsts()) )
+    return false;
+
+  output.verbose(CALL_INFO, 1, 0, "Replayed %" PRIu64 " memory trace records in %" PRIu64 " cycles\n",
+                 Replay->GetNumRecords(), (uint64_t)(currentCycle - ReplayStartCycle));
+  primaryComponentOKToEndSim();
+  return true;
 }
 
 bool RevCPU::clockTick( SST::Cycle_t currentCycle ){
@@ -2370,6 +2641,10 @@ bool RevCPU::clockTick( SST::Cycle_t currentCycle ){
       output.fatal(CALL_INFO, -1, "Error: failed to process the PAN zero address put queue\n" );
   }
 
+  // dump the page heat map at the end of each interval
+  if( EnableHeatMap && HeatMapInterval && (currentCycle % HeatMapInterval) == 0 )
+    Mem->DumpHeatMap(false);
+
   // check to see if we need to inject a fault
   if( EnableFaults ){
     if( FaultCntr == 0 ){
@@ -2383,6 +2658,11 @@ bool RevCPU::clockTick( SST::Cycle_t currentCycle ){
     }
   }
 
+  // write the checkpoint once every core has drained its pipeline
+  if( !CheckpointDone && !CheckpointFile.empty() &&
+      (currentCycle >= CheckpointCycle) && IsQuiescent() )
+    WriteCheckpoint(currentCycle);
+
   // check to see if all the processors are completed
   for( unsigned i=0; i<Procs.size(); i++ ){
     if( Enabled[i] )
@@ -0,0 +1,61 @@
+//
+// _RevCache_cc_
+//
+// Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+//
+// See LICENSE in the top level directory for licensing details
+//
+
+#include "../include/RevCache.h"
+
+using namespace SST;
+using namespace RevCPU;
+
+RevCache::RevCache( const RevCacheConfig &Config, SST::Output *Output )
+  : config(Config), sets(0), ways(Config.Ways), lineShift(0), setMask(0),
+    stamp(0), hits(0), misses(0), output(Output){
+
+  if( (config.LineSize < 4) || ((config.LineSize & (config.LineSize-1)) != 0) )
+    output->fatal(CALL_INFO, -1, "Error: cache line size must be a power of two >= 4; lineSize=%u\n",
+                  config.LineSize);
+  if( ways == 0 )
+    output->fatal(CALL_INFO, -1, "Error: cache associativity must be non-zero\n");
+
+  const uint64_t Lines = config.Size / config.LineSize;
+  if( (Lines < ways) || ((Lines % ways) != 0) )
+    output->fatal(CALL_INFO, -1, "Error: cache size of %" PRIu64 " bytes does not hold a multiple of %u ways of %u byte lines\n",
+                  config.Size, ways, config.LineSize);
+
+  sets = (unsigned)(Lines / ways);
+  if( (sets & (sets-1)) != 0 )
+    output->fatal(CALL_INFO, -1, "Error: number of cache sets must be a power of two; sets=%u\n", sets);
+
+  lineShift = (unsigned)(__builtin_ctz(config.LineSize));
+  setMask = (uint64_t)(sets-1);
+
+  Tags.resize((size_t)(sets)*ways);
+  LRU.resize((size_t)(sets)*ways);
+  Flush();
+}
+
+RevCache::~RevCache(){
+}
+
+void RevCache::Flush(){
+  std::fill(Tags.begin(), Tags.end(), _INVALID_ADDR_);
+  std::fill(LRU.begin(), LRU.end(), 0x00ull);
+}
+
+void RevCache::Fill( unsigned Base, uint64_t Line ){
+  unsigned Victim = 0;
+  for( unsigned w=1; w<ways; w++ ){
+    if( LRU[Base+w] < LRU[Base+Victim] )
+      Victim = w;
+  }
+  Tags[Base+Victim] = Line;
+  LRU[Base+Victim] = stamp;
+}
+
+// EOF
@@ -0,0 +1,100 @@
+//
+// _RevCheckpoint_cc_
+//
+// Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+//
+// See LICENSE in the top level directory for licensing details
+//
+
+#include "../include/RevCheckpoint.h"
+#include <cstring>
+#include <algorithm>
+
+using namespace SST;
+using namespace RevCPU;
+
+RevCheckpoint::RevCheckpoint( const std::string &File, bool Write, SST::Output *Output )
+  : file(nullptr), name(File), writing(Write), output(Output){
+
+  file = fopen(File.c_str(), Write ? "wb" : "rb");
+  if( !file )
+    output->fatal(CALL_INFO, -1, "Error: could not open checkpoint file %s\n", File.c_str());
+
+  if( writing ){
+    PutBytes(_REV_CKPT_MAGIC_, strlen(_REV_CKPT_MAGIC_));
+    Put<uint32_t>(_REV_CKPT_VERSION_);
+    return ;
+  }
+
+  char Magic[sizeof(_REV_CKPT_MAGIC_)] = {};
+  uint32_t Version = 0;
+  if( (fread(Magic, 1, strlen(_REV_CKPT_MAGIC_), file) != strlen(_REV_CKPT_MAGIC_)) ||
+      (strcmp(Magic, _REV_CKPT_MAGIC_) != 0) ||
+      (fread(&Version, sizeof(Version), 1, file) != 1) )
+    output->fatal(CALL_INFO, -1, "Error: %s is not a checkpoint\n", File.c_str());
+  if( Version != _REV_CKPT_VERSION_ )
+    output->fatal(CALL_INFO, -1, "Error: unsupported checkpoint version %u in %s\n",
+                  Version, File.c_str());
+}
+
+RevCheckpoint::~RevCheckpoint(){
+  if( !file )
+    return ;
+  if( fclose(file) != 0 && writing )
+    output->fatal(CALL_INFO, -1, "Error: failed to write checkpoint file %s\n", name.c_str());
+}
+
+void RevCheckpoint::PutBytes( const void *Data, size_t Len ){
+  if( fwrite(Data, 1, Len, file) != Len )
+    output->fatal(CALL_INFO, -1, "Error: failed to write checkpoint file %s\n", name.c_str());
+}
+
+void RevCheckpoint::GetBytes( void *Data, size_t Len ){
+  if( fread(Data, 1, Len, file) != Len )
+    output->fatal(CALL_INFO, -1, "Error: checkpoint file %s is truncated\n", name.c_str());
+}
+
+void RevCheckpoint::Section( const char *Name ){
+  if( writing ){
+    PutString(Name);
+    return ;
+  }
+  const std::string S = GetString();
+  if( S != Name )
+    output->fatal(CALL_INFO, -1, "Error: checkpoint file %s is corrupt; expected section %s, found %s\n",
+                  name.c_str(), Name, S.c_str());
+}
+
+void RevCheckpoint::PutString( const std::string &S ){
+  Put<uint32_t>((uint32_t)(S.size()));
+  PutBytes(S.data(), S.size());
+}
+
+std::string RevCheckpoint::GetString(){
+  std::string S(Get<uint32_t>(), '\0');
+  if( !S.empty() )
+    GetBytes(&S[0], S.size());
+  return S;
+}
+
+uint64_t RevCheckpoint::AlignTo( uint64_t Align ){
+  const uint64_t Off = (uint64_t)(ftello(file));
+  const uint64_t Pad = (Align - (Off % Align)) % Align;
+  if( writing ){
+    static const char Zero[64] = {};
+    for( uint64_t i=0; i<Pad; i+=sizeof(Zero) )
+      PutBytes(Zero, std::min(Pad-i, (uint64_t)(sizeof(Zero))));
+  }else{
+    Skip(Pad);
+  }
+  return Off + Pad;
+}
+
+void RevCheckpoint::Skip( uint64_t Len ){
+  if( fseeko(file, (off_t)(Len), SEEK_CUR) != 0 )
+    output->fatal(CALL_INFO, -1, "Error: checkpoint file %s is truncated\n", name.c_str());
+}
+
+// EOF
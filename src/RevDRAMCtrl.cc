@@ -0,0 +1,479 @@
+//
+// _RevDRAMCtrl_cc_
+//
+// Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+//
+// See LICENSE in the top level directory for licensing details
+//
+
+#include "../include/RevDRAMCtrl.h"
+#include <cstring>
+#include <unordered_set>
+
+using namespace SST;
+using namespace RevCPU;
+
+RevDRAMCtrl::RevDRAMCtrl(ComponentId_t id, Params& params)
+  : RevMemCtrl(id,params), numBanks(8), rowSize(2048), tRCD(14), tCAS(14), tRP(14),
+    openPage(true), busBytes(16), schedWindow(16), maxOps(2), curCycle(0), busFree(0),
+    timeConverter(nullptr), clockHandler(nullptr), clockActive(false), numRqsts(0),
+    numRowHits(0), numRowEmpty(0), numRowConflicts(0), busCycles(0){
+
+  std::string ClockFreq = params.find<std::string>("clock", "1Ghz");
+
+  numBanks = params.find<unsigned>("banks", 8);
+  rowSize = params.find<unsigned>("row_size", 2048);
+  tRCD = params.find<unsigned>("tRCD", 14);
+  tCAS = params.find<unsigned>("tCAS", 14);
+  tRP = params.find<unsigned>("tRP", 14);
+  busBytes = params.find<unsigned>("bus_bytes", 16);
+  schedWindow = params.find<unsigned>("sched_window", 16);
+  maxOps = params.find<unsigned>("ops_per_cycle", 2);
+
+  std::string Policy = params.find<std::string>("page_policy", "open");
+  if( Policy == "open" ){
+    openPage = true;
+  }else if( Policy == "closed" ){
+    openPage = false;
+  }else{
+    output->fatal(CALL_INFO, -1, "Error : unknown page_policy %s; expected open or closed\n",
+                  Policy.c_str());
+  }
+
+  if( (numBanks == 0) || (rowSize == 0) || (busBytes == 0) ||
+      (schedWindow == 0) || (maxOps == 0) ){
+    output->fatal(CALL_INFO, -1,
+                  "Error : banks, row_size, bus_bytes, sched_window and ops_per_cycle must be nonzero\n");
+  }
+
+  banks.resize(numBanks, RevDRAMBank{_INVALID_ADDR_, 0});
+
+  stats.push_back(registerStatistic<uint64_t>("ReadBytes"));
+  stats.push_back(registerStatistic<uint64_t>("WriteBytes"));
+  stats.push_back(registerStatistic<uint64_t>("RowHits"));
+  stats.push_back(registerStatistic<uint64_t>("RowEmpty"));
+  stats.push_back(registerStatistic<uint64_t>("RowConflicts"));
+  stats.push_back(registerStatistic<uint64_t>("ReadLatency"));
+  stats.push_back(registerStatistic<uint64_t>("WriteLatency"));
+  stats.push_back(registerStatistic<uint64_t>("BusBusy"));
+
+  clockHandler = new Clock::Handler<RevDRAMCtrl>(this,&RevDRAMCtrl::clockTick);
+  timeConverter = registerClock( ClockFreq, clockHandler );
+  clockActive = true;
+}
+
+RevDRAMCtrl::~RevDRAMCtrl(){
+  // a split request may have transactions both queued and in flight
+  std::unordered_set<RevMemOp *> Ops;
+  for( auto &T : rqstQ )
+    Ops.insert(T.Op);
+  for( auto &I : inflight )
+    Ops.insert(I.second);
+  for( RevMemOp *op : Ops )
+    delete op;
+}
+
+void RevDRAMCtrl::finish(){
+  const uint64_t Txns = numRowHits + numRowEmpty + numRowConflicts;
+  if( Txns == 0 )
+    return ;
+  // the clock may have been released, so read the cycle from the simulation time
+  const uint64_t Cycles = getCurrentSimTime(timeConverter);
+  output->verbose(CALL_INFO, 1, 0,
+                  "DRAM: transactions=%" PRIu64 " row_hits=%" PRIu64 " row_empty=%" PRIu64
+                  " row_conflicts=%" PRIu64 " hit_rate=%.1f%% bus_utilization=%.1f%%\n",
+                  Txns, numRowHits, numRowEmpty, numRowConflicts,
+                  100.0 * (double)(numRowHits) / (double)(Txns),
+                  Cycles ? (100.0 * (double)(busCycles) / (double)(Cycles)) : 0.0);
+}
+
+void RevDRAMCtrl::wakeClock(){
+  curCycle = reregisterClock(timeConverter, clockHandler);
+  clockActive = true;
+}
+
+bool RevDRAMCtrl::outstandingRqsts(){
+  return numRqsts > 0;
+}
+
+uint64_t RevDRAMCtrl::getNumPendingRqsts(){
+  return numRqsts;
+}
+
+// ---------------------------------------------------------------
+// Backing store
+// ---------------------------------------------------------------
+uint8_t *RevDRAMCtrl::getPage(uint64_t Addr){
+  std::vector<uint8_t> &P = backing[Addr / _REV_DRAM_PAGE_];
+  if( P.empty() )
+    P.resize(_REV_DRAM_PAGE_, 0);
+  return P.data();
+}
+
+void RevDRAMCtrl::readBacking(uint64_t Addr, uint32_t Size, uint8_t *Data){
+  uint32_t Cur = 0;
+  while( Cur < Size ){
+    const uint64_t A = Addr + Cur;
+    const uint32_t Off = (uint32_t)(A % _REV_DRAM_PAGE_);
+    const uint32_t Span = std::min(Size - Cur, (uint32_t)(_REV_DRAM_PAGE_) - Off);
+    // untouched pages read as zero without being allocated
+    auto it = backing.find(A / _REV_DRAM_PAGE_);
+    if( it == backing.end() )
+      std::memset(&Data[Cur], 0, Span);
+    else
+      std::memcpy(&Data[Cur], &it->second[Off], Span);
+    Cur += Span;
+  }
+}
+
+void RevDRAMCtrl::writeBacking(uint64_t Addr, uint32_t Size, const uint8_t *Data){
+  uint32_t Cur = 0;
+  while( Cur < Size ){
+    const uint64_t A = Addr + Cur;
+    const uint32_t Off = (uint32_t)(A % _REV_DRAM_PAGE_);
+    const uint32_t Span = std::min(Size - Cur, (uint32_t)(_REV_DRAM_PAGE_) - Off);
+    std::memcpy(getPage(A) + Off, &Data[Cur], Span);
+    Cur += Span;
+  }
+}
+
+// ---------------------------------------------------------------
+// Requests
+// ---------------------------------------------------------------
+void RevDRAMCtrl::enqueueRqst(RevMemOp *op){
+  if( !clockActive )
+    wakeClock();
+  op->setCore(activeCore);
+  op->setEnqueueCycle(curCycle);
+  numRqsts++;
+
+  if( op->getOp() == RevMemOp::MemOp::MemOpFENCE ){
+    rqstQ.push_back(RevDRAMTxn{op, 0, 0, 0});
+    return ;
+  }
+
+  // one transaction per row touched
+  uint64_t Addr = op->getAddr();
+  uint32_t Left = op->getSize();
+  unsigned Num = 0;
+  while( Left > 0 ){
+    const uint32_t Span = std::min(Left, rowSize - (uint32_t)(Addr % rowSize));
+    const uint64_t R = Addr / rowSize;
+    rqstQ.push_back(RevDRAMTxn{op, Span, (unsigned)(R % numBanks), R / numBanks});
+    Addr += Span;
+    Left -= Span;
+    Num++;
+  }
+  op->setSplitRqst(Num);
+}
+
+bool RevDRAMCtrl::sendREADRequest(uint64_t Addr,
+                                  uint64_t PAddr,
+                                  uint32_t Size,
+                                  void *target,
+                                  StandardMem::Request::flags_t flags){
+  if( Size == 0 )
+    return true;
+  // the data is captured now and delivered when the transactions complete
+  RevMemOp *Op = nullptr;
+  if( Size <= _REV_MEMOP_INLINE_ ){
+    uint8_t Data[_REV_MEMOP_INLINE_];
+    readBacking(Addr, Size, Data);
+    Op = new RevMemOp(Addr, PAddr, Size, (char *)(Data), target, RevMemOp::MemOp::MemOpREAD, flags);
+  }else{
+    std::vector<uint8_t> Data(Size);
+    readBacking(Addr, Size, Data.data());
+    Op = new RevMemOp(Addr, PAddr, Size, (char *)(Data.data()), target, RevMemOp::MemOp::MemOpREAD, flags);
+  }
+  enqueueRqst(Op);
+  recordStat(ReadBytes, Size);
+  return true;
+}
+
+bool RevDRAMCtrl::sendWRITERequest(uint64_t Addr,
+                                   uint64_t PAddr,
+                                   uint32_t Size,
+                                   char *buffer,
+                                   StandardMem::Request::flags_t flags){
+  if( Size == 0 )
+    return true;
+  writeBacking(Addr, Size, (const uint8_t *)(buffer));
+  enqueueRqst(new RevMemOp(Addr, PAddr, Size, RevMemOp::MemOp::MemOpWRITE, flags));
+  recordStat(WriteBytes, Size);
+  return true;
+}
+
+bool RevDRAMCtrl::sendREADLOCKRequest(uint64_t Addr,
+                                      uint64_t PAddr,
+                                      uint32_t Size,
+                                      void *target,
+                                      StandardMem::Request::flags_t flags){
+  return sendREADRequest(Addr, PAddr, Size, target, flags);
+}
+
+bool RevDRAMCtrl::sendWRITELOCKRequest(uint64_t Addr,
+                                       uint64_t PAddr,
+                                       uint32_t Size,
+                                       char *buffer,
+                                       StandardMem::Request::flags_t flags){
+  return sendWRITERequest(Addr, PAddr, Size, buffer, flags);
+}
+
+bool RevDRAMCtrl::sendAMORequest(uint64_t Addr,
+                                 uint64_t PAddr,
+                                 uint32_t Size,
+                                 char *buffer,
+                                 void *target,
+                                 StandardMem::Request::flags_t flags){
+  if( (Size != 4) && (Size != 8) )
+    output->fatal(CALL_INFO, -1, "Error : unsupported AMO size of %u bytes\n", Size);
+
+  // update memory now; the prior value is returned when the access completes
+  uint8_t Old[8];
+  readBacking(Addr, Size, Old);
+  if( Size == 4 ){
+    uint32_t O = 0;
+    uint32_t V = 0;
+    std::memcpy(&O, Old, sizeof(uint32_t));
+    std::memcpy(&V, buffer, sizeof(uint32_t));
+    uint32_t New = RevAMOCompute(O, V, flags);
+    writeBacking(Addr, Size, (const uint8_t *)(&New));
+  }else{
+    uint64_t O = 0;
+    uint64_t V = 0;
+    std::memcpy(&O, Old, sizeof(uint64_t));
+    std::memcpy(&V, buffer, sizeof(uint64_t));
+    uint64_t New = RevAMOCompute(O, V, flags);
+    writeBacking(Addr, Size, (const uint8_t *)(&New));
+  }
+
+  enqueueRqst(new RevMemOp(Addr, PAddr, Size, (char *)(Old), target,
+                           RevMemOp::MemOp::MemOpREADLOCK, flags));
+  recordStat(ReadBytes, Size);
+  recordStat(WriteBytes, Size);
+  return true;
+}
+
+bool RevDRAMCtrl::sendLOADLINKRequest(uint64_t Addr,
+                                      uint64_t PAddr,
+                                      uint32_t Size,
+                                      StandardMem::Request::flags_t flags){
+  if( Size == 0 )
+    return true;
+  enqueueRqst(new RevMemOp(Addr, PAddr, Size, RevMemOp::MemOp::MemOpLOADLINK, flags));
+  recordStat(ReadBytes, Size);
+  return true;
+}
+
+bool RevDRAMCtrl::sendSTORECONDRequest(uint64_t Addr,
+                                       uint64_t PAddr,
+                                       uint32_t Size,
+                                       char *buffer,
+                                       StandardMem::Request::flags_t flags){
+  return sendWRITERequest(Addr, PAddr, Size, buffer, flags);
+}
+
+bool RevDRAMCtrl::sendCUSTOMREADRequest(uint64_t Addr,
+                                        uint64_t PAddr,
+                                        uint32_t Size,
+                                        void *target,
+                                        unsigned Opc,
+                                        StandardMem::Request::flags_t flags){
+  output->fatal(CALL_INFO, -1, "Error : RevDRAMCtrl does not support custom memory requests\n");
+  return false;
+}
+
+bool RevDRAMCtrl::sendCUSTOMWRITERequest(uint64_t Addr,
+                                         uint64_t PAddr,
+                                         uint32_t Size,
+                                         char *buffer,
+                                         unsigned Opc,
+                                         StandardMem::Request::flags_t flags){
+  output->fatal(CALL_INFO, -1, "Error : RevDRAMCtrl does not support custom memory requests\n");
+  return false;
+}
+
+bool RevDRAMCtrl::sendFENCE(){
+  enqueueRqst(new RevMemOp(0x00ull, 0x00ull, 0x00, RevMemOp::MemOp::MemOpFENCE, 0x00));
+  return true;
+}
+
+// ---------------------------------------------------------------
+// Responses
+// ---------------------------------------------------------------
+void RevDRAMCtrl::handleReadResp(StandardMem::ReadResp* ev){
+  output->fatal(CALL_INFO, -1, "Error : RevDRAMCtrl received a StandardMem response\n");
+}
+
+void RevDRAMCtrl::handleWriteResp(StandardMem::WriteResp* ev){
+  output->fatal(CALL_INFO, -1, "Error : RevDRAMCtrl received a StandardMem response\n");
+}
+
+void RevDRAMCtrl::handleFlushResp(StandardMem::FlushResp* ev){
+  output->fatal(CALL_INFO, -1, "Error : RevDRAMCtrl received a StandardMem response\n");
+}
+
+void RevDRAMCtrl::handleCustomResp(StandardMem::CustomResp* ev){
+  output->fatal(CALL_INFO, -1, "Error : RevDRAMCtrl received a StandardMem response\n");
+}
+
+void RevDRAMCtrl::handleInvResp(StandardMem::InvNotify* ev){
+  output->fatal(CALL_INFO, -1, "Error : RevDRAMCtrl received a StandardMem response\n");
+}
+
+void RevDRAMCtrl::handleFlagResp(RevMemOp *op){
+  StandardMem::Request::flags_t flags = op->getFlags();
+
+  if( ((uint32_t)(flags) & (uint32_t)(RevCPU::RevFlag::F_SEXT32)) ){
+    uint32_t *target = (uint32_t *)(op->getTarget());
+    SEXTI(*target,32);
+  }else if( ((uint32_t)(flags) & (uint32_t)(RevCPU::RevFlag::F_SEXT64)) ){
+    uint64_t *target = (uint64_t *)(op->getTarget());
+    SEXTI(*target,64);
+  }else if( ((uint32_t)(flags) & (uint32_t)(RevCPU::RevFlag::F_ZEXT32)) ){
+    uint32_t *target = (uint32_t *)(op->getTarget());
+    ZEXTI(*target,32);
+  }else if( ((uint32_t)(flags) & (uint32_t)(RevCPU::RevFlag::F_ZEXT64)) ){
+    uint64_t *target = (uint64_t *)(op->getTarget());
+    ZEXTI64(*target,63);
+  }
+}
+
+void RevDRAMCtrl::completeRqst(RevMemOp *op){
+  const uint64_t Latency = curCycle - op->getEnqueueCycle();
+  switch(op->getOp()){
+  case RevMemOp::MemOp::MemOpREAD:
+    std::memcpy(op->getTarget(), op->getBuf(), op->getSize());
+    handleFlagResp(op);
+    recordStat(ReadLatency, Latency);
+    break;
+  case RevMemOp::MemOp::MemOpREADLOCK:
+    // AMO: return the prior memory value
+    if( (op->getSize() == 4) &&
+        ((uint32_t)(op->getFlags()) & (uint32_t)(RevCPU::RevFlag::F_SEXT64)) ){
+      uint32_t Old = 0;
+      std::memcpy(&Old, op->getBuf(), sizeof(uint32_t));
+      uint64_t *target = (uint64_t *)(op->getTarget());
+      *target = (uint64_t)((int64_t)((int32_t)(Old)));
+    }else{
+      std::memcpy(op->getTarget(), op->getBuf(), op->getSize());
+    }
+    recordStat(ReadLatency, Latency);
+    break;
+  case RevMemOp::MemOp::MemOpLOADLINK:
+    recordStat(ReadLatency, Latency);
+    break;
+  default:
+    recordStat(WriteLatency, Latency);
+    break;
+  }
+  numRqsts--;
+  delete op;
+}
+
+// ---------------------------------------------------------------
+// Scheduling
+// ---------------------------------------------------------------
+void RevDRAMCtrl::issueTxn(RevDRAMTxn &T){
+  RevDRAMBank &B = banks[T.Bank];
+
+  // cycle the row is open and ready for the column command
+  uint64_t Act = curCycle;
+  if( B.OpenRow == T.Row ){
+    numRowHits++;
+    recordStat(RowHits, 1);
+  }else if( B.OpenRow == _INVALID_ADDR_ ){
+    Act += tRCD;
+    numRowEmpty++;
+    recordStat(RowEmpty, 1);
+  }else{
+    Act += tRP + tRCD;
+    numRowConflicts++;
+    recordStat(RowConflicts, 1);
+  }
+
+  // an AMO reads the old value and writes the new one in the same row
+  uint64_t Burst = (T.Size + busBytes - 1) / busBytes;
+  if( T.Op->isAMO() )
+    Burst *= 2;
+
+  const uint64_t Start = std::max(Act + tCAS, busFree);
+  const uint64_t Done = Start + Burst;
+  busFree = Done;
+  busCycles += Burst;
+  recordStat(BusBusy, Burst);
+
+  if( openPage ){
+    // the next column command may issue so its data follows this burst
+    B.OpenRow = T.Row;
+    B.Ready = Done - tCAS;
+  }else{
+    B.OpenRow = _INVALID_ADDR_;
+    B.Ready = Done + tRP;
+  }
+
+  inflight.emplace(Done, T.Op);
+}
+
+void RevDRAMCtrl::schedule(){
+  unsigned Issued = 0;
+  while( (Issued < maxOps) && !rqstQ.empty() ){
+    // a fence retires once everything ahead of it has completed
+    if( rqstQ.front().Op->getOp() == RevMemOp::MemOp::MemOpFENCE ){
+      if( !inflight.empty() )
+        return ;
+      delete rqstQ.front().Op;
+      rqstQ.pop_front();
+      numRqsts--;
+      continue;
+    }
+
+    // oldest row hit to a ready bank, else the oldest transaction to a ready bank
+    auto Best = rqstQ.end();
+    unsigned N = 0;
+    for( auto it = rqstQ.begin(); (it != rqstQ.end()) && (N < schedWindow); ++it, N++ ){
+      if( it->Op->getOp() == RevMemOp::MemOp::MemOpFENCE )
+        break;
+      const RevDRAMBank &B = banks[it->Bank];
+      if( B.Ready > curCycle )
+        continue;
+      if( B.OpenRow == it->Row ){
+        Best = it;
+        break;
+      }
+      if( Best == rqstQ.end() )
+        Best = it;
+    }
+    if( Best == rqstQ.end() )
+      return ;
+
+    issueTxn(*Best);
+    rqstQ.erase(Best);
+    Issued++;
+  }
+}
+
+bool RevDRAMCtrl::clockTick(Cycle_t cycle){
+  curCycle = cycle;
+
+  // retire the transactions whose data has arrived
+  while( !inflight.empty() && (inflight.begin()->first <= curCycle) ){
+    RevMemOp *op = inflight.begin()->second;
+    inflight.erase(inflight.begin());
+    if( op->retireSplitRqst() == 0 )
+      completeRqst(op);
+  }
+
+  schedule();
+
+  if( rqstQ.empty() && inflight.empty() ){
+    // nothing left to time; sleep until the next request arrives
+    clockActive = false;
+    return true;
+  }
+  return false;
+}
+
+// EOF
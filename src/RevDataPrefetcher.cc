@@ -0,0 +1,146 @@
+//
+// _RevDataPrefetcher_cc_
+//
+// Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+//
+// See LICENSE in the top level directory for licensing details
+//
+
+#include "../include/RevDataPrefetcher.h"
+
+using namespace SST;
+using namespace RevCPU;
+
+// ---------------------------------------------------------------
+// RevDataPrefetcher
+// ---------------------------------------------------------------
+RevDataPrefetcher::RevDataPrefetcher( ComponentId_t id, Params& params )
+  : SubComponent(id), output(nullptr), degree(2){
+  uint32_t verbosity = params.find<uint32_t>("verbose", 0);
+  output = new SST::Output("[RevDataPrefetcher @t]: ", verbosity, 0, SST::Output::STDOUT);
+  degree = params.find<unsigned>("degree", 2);
+}
+
+RevDataPrefetcher::~RevDataPrefetcher(){
+  delete output;
+}
+
+// ---------------------------------------------------------------
+// RevNextLinePrefetcher
+// ---------------------------------------------------------------
+RevNextLinePrefetcher::RevNextLinePrefetcher( ComponentId_t id, Params& params )
+  : RevDataPrefetcher(id, params), lastLine(_INVALID_ADDR_){
+}
+
+void RevNextLinePrefetcher::observe( uint64_t Addr, uint64_t PC, unsigned LineSize,
+                                     std::vector<uint64_t> &Lines ){
+  const uint64_t Line = Addr - (Addr % LineSize);
+  if( Line == lastLine )
+    return ;
+  lastLine = Line;
+  for( unsigned k=1; k<=degree; k++ ){
+    propose(Line, Line + (uint64_t)(k) * LineSize, Lines);
+  }
+}
+
+// ---------------------------------------------------------------
+// RevStridePrefetcher
+// ---------------------------------------------------------------
+RevStridePrefetcher::RevStridePrefetcher( ComponentId_t id, Params& params )
+  : RevDataPrefetcher(id, params){
+  unsigned Size = params.find<unsigned>("table_size", 64);
+  if( Size == 0 )
+    output->fatal(CALL_INFO, -1, "Error: stride prefetcher table_size must be nonzero\n");
+  table.resize(Size, RevStrideEntry{_INVALID_ADDR_, 0, 0, 0});
+}
+
+void RevStridePrefetcher::observe( uint64_t Addr, uint64_t PC, unsigned LineSize,
+                                   std::vector<uint64_t> &Lines ){
+  RevStrideEntry &E = table[(PC >> 1) % table.size()];
+  if( E.PC != PC ){
+    E = RevStrideEntry{PC, Addr, 0, 0};
+    return ;
+  }
+
+  const int64_t Stride = (int64_t)(Addr - E.LastAddr);
+  E.LastAddr = Addr;
+  if( Stride == 0 )
+    return ;
+  if( Stride != E.Stride ){
+    E.Stride = Stride;
+    E.Confidence = 0;
+    return ;
+  }
+  if( E.Confidence < 3 )
+    E.Confidence++;
+
+  // strides shorter than a line advance a line at a time
+  int64_t Step = Stride;
+  if( (Step > -(int64_t)(LineSize)) && (Step < (int64_t)(LineSize)) )
+    Step = (Step > 0) ? (int64_t)(LineSize) : -(int64_t)(LineSize);
+
+  const uint64_t Line = Addr - (Addr % LineSize);
+  for( unsigned k=1; k<=degree; k++ ){
+    const uint64_t Target = Addr + (uint64_t)(Step * (int64_t)(k));
+    propose(Line, Target - (Target % LineSize), Lines);
+  }
+}
+
+// ---------------------------------------------------------------
+// RevStreamPrefetcher
+// ---------------------------------------------------------------
+RevStreamPrefetcher::RevStreamPrefetcher( ComponentId_t id, Params& params )
+  : RevDataPrefetcher(id, params), window(4), now(0){
+  unsigned Num = params.find<unsigned>("streams", 8);
+  window = params.find<unsigned>("window", 4);
+  if( Num == 0 )
+    output->fatal(CALL_INFO, -1, "Error: stream prefetcher must track at least one stream\n");
+  streams.resize(Num, RevStreamEntry{0, 0, 0, 0, false});
+}
+
+void RevStreamPrefetcher::observe( uint64_t Addr, uint64_t PC, unsigned LineSize,
+                                   std::vector<uint64_t> &Lines ){
+  const uint64_t L = Addr / LineSize;
+  now++;
+
+  RevStreamEntry *S = nullptr;
+  RevStreamEntry *Victim = &streams[0];
+  for( auto &E : streams ){
+    if( E.Valid &&
+        (((L >= E.LastLine) ? (L - E.LastLine) : (E.LastLine - L)) <= window) ){
+      S = &E;
+      break;
+    }
+    if( !E.Valid || (Victim->Valid && (E.LRU < Victim->LRU)) )
+      Victim = &E;
+  }
+
+  if( !S ){
+    *Victim = RevStreamEntry{L, 0, 0, now, true};
+    return ;
+  }
+
+  S->LRU = now;
+  if( L == S->LastLine )
+    return ;
+  const int Dir = (L > S->LastLine) ? 1 : -1;
+  if( Dir == S->Dir ){
+    if( S->Confidence < 3 )
+      S->Confidence++;
+  }else{
+    S->Dir = Dir;
+    S->Confidence = 0;
+  }
+  S->LastLine = L;
+  if( S->Confidence == 0 )
+    return ;
+
+  for( unsigned k=1; k<=degree; k++ ){
+    const uint64_t Next = L + (uint64_t)((int64_t)(Dir) * (int64_t)(k));
+    propose(L * LineSize, Next * LineSize, Lines);
+  }
+}
+
+// EOF
@@ -11,6 +11,8 @@
 #include "../include/RevMem.h"
 #include <math.h>
 #include <mutex>
+#include <sys/mman.h>
+#include <unistd.h>
 
 RevMem::RevMem( unsigned long MemSize, RevOpts *Opts,
                 RevMemCtrl *Ctrl, SST::Output *Output )
@@ -20,6 +22,7 @@ RevMem::RevMem( unsigned long MemSize, RevOpts *Opts,
   pageSize = 262144; //Page Size (in Bytes)
   addrShift = int(log(pageSize) / log(2.0));
   nextPage = 0;
+  pageTable = new RevPageTable(64 - addrShift, _REVMEM_PT_BITS_, output);
 
   stacktop = _REVMEM_BASE_ + memSize;
 
@@ -31,25 +34,36 @@ RevMem::RevMem( unsigned long MemSize, RevOpts *Opts,
   memStats.floatsWritten = 0;
   memStats.TLBHits = 0;
   memStats.TLBMisses = 0;
+  memStats.SCAttempts = 0;
+  memStats.SCFailures = 0;
+  memStats.L1Hits = 0;
+  memStats.L1Misses = 0;
+  memStats.L2Hits = 0;
+  memStats.L2Misses = 0;
+  memStats.RegionAccesses = 0;
+  memStats.RegionStalls = 0;
+
+  SetTLBSize(512, 8);
 }
 
 RevMem::RevMem( unsigned long MemSize, RevOpts *Opts, SST::Output *Output )
-  : physMem(nullptr), memSize(MemSize), opts(Opts), ctrl(nullptr), output(Output),
+  : physMem(nullptr), activeCore(0), activeTLB(nullptr), activeHostTLB(nullptr), memSize(MemSize), opts(Opts), ctrl(nullptr), output(Output),
     stacktop(0x00ull) {
 
-  // allocate the backing memory
-  physMem = new char [memSize];
+  // allocate the backing memory; the host kernel zero-fills each page on first touch
+  int mapFlags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+  mapFlags |= MAP_NORESERVE;
+#endif
+  void *mem = mmap(nullptr, memSize, PROT_READ | PROT_WRITE, mapFlags, -1, 0);
+  if( mem == MAP_FAILED )
+    output->fatal(CALL_INFO, -1, "Error: could not allocate backing memory\n");
+  physMem = (char *)(mem);
+
   pageSize = 262144; //Page Size (in Bytes)
   addrShift = int(log(pageSize) / log(2.0));
   nextPage = 0;
-
-  if( !physMem )
-    output->fatal(CALL_INFO, -1, "Error: could not allocate backing memory\n");
-
-  // zero the memory
-  for( unsigned long i=0; i<memSize; i++ ){
-    physMem[i] = 0;
-  }
+  pageTable = new RevPageTable(64 - addrShift, _REVMEM_PT_BITS_, output);
 
   stacktop = _REVMEM_BASE_ + memSize;
 
@@ -61,11 +75,363 @@ RevMem::RevMem( unsigned long MemSize, RevOpts *Opts, SST::Output *Output )
   memStats.floatsWritten = 0;
   memStats.TLBHits = 0;
   memStats.TLBMisses = 0;
+  memStats.SCAttempts = 0;
+  memStats.SCFailures = 0;
+  memStats.L1Hits = 0;
+  memStats.L1Misses = 0;
+  memStats.L2Hits = 0;
+  memStats.L2Misses = 0;
+  memStats.RegionAccesses = 0;
+  memStats.RegionStalls = 0;
+
+  SetTLBSize(512, 8);
 }
 
 RevMem::~RevMem(){
+  for( unsigned i=0; i<TLBs.size(); i++ )
+    delete TLBs[i];
+  for( unsigned l=0; l<_REVMEM_CACHE_LEVELS_; l++ ){
+    for( unsigned i=0; i<Caches[l].size(); i++ )
+      delete Caches[l][i];
+  }
+  if( heatFile )
+    fclose(heatFile);
+  delete pageTable;
   if( physMem )
-    delete[] physMem;
+    munmap(physMem, memSize);
+}
+
+void RevMem::EnableHugePages(){
+  if( !physMem )
+    return ;
+#ifdef MADV_HUGEPAGE
+  if( madvise(physMem, memSize, MADV_HUGEPAGE) != 0 )
+    output->verbose(CALL_INFO, 1, 0,
+                    "Warning: transparent huge pages could not be enabled for the backing memory\n");
+#else
+  output->verbose(CALL_INFO, 1, 0,
+                  "Warning: transparent huge pages are not supported on this host\n");
+#endif
+}
+
+void RevMem::SetTLBSize(unsigned numEntries, unsigned numWays){
+  for( unsigned i=0; i<TLBs.size(); i++ )
+    delete TLBs[i];
+  TLBs.clear();
+
+  // each core owns a private TLB; cores tick sequentially so
+  // the active TLB is selected by the issuing core
+  unsigned numCores = opts->GetNumCores();
+  if( numCores == 0 )
+    numCores = 1;
+  for( unsigned i=0; i<numCores; i++ ){
+    TLBs.push_back( new RevTLB(numEntries, numWays, output) );
+  }
+  HostTLB.resize(numCores * _REVMEM_HOSTTLB_ENTRIES_);
+  FlushTLB();
+  SetActiveCore(0);
+}
+
+void RevMem::EnableCacheModel(const RevCacheConfig &L1, const RevCacheConfig &L2){
+  if( L1.Size == 0 )
+    output->fatal(CALL_INFO, -1, "Error: the cache model requires a non-zero L1 size\n");
+
+  unsigned numCores = opts->GetNumCores();
+  if( numCores == 0 )
+    numCores = 1;
+
+  const RevCacheConfig Levels[_REVMEM_CACHE_LEVELS_] = {L1, L2};
+  for( unsigned l=0; l<_REVMEM_CACHE_LEVELS_; l++ ){
+    for( unsigned i=0; i<Caches[l].size(); i++ )
+      delete Caches[l][i];
+    Caches[l].clear();
+    CacheHits[l].assign(numCores, 0);
+    CacheMisses[l].assign(numCores, 0);
+    if( Levels[l].Size == 0 )
+      continue;
+    const unsigned Instances = Levels[l].Shared ? 1 : numCores;
+    for( unsigned i=0; i<Instances; i++ ){
+      Caches[l].push_back( new RevCache(Levels[l], output) );
+    }
+  }
+  cacheModel = true;
+}
+
+void RevMem::Checkpoint(RevCheckpoint &C){
+  if( !physMem )
+    output->fatal(CALL_INFO, -1, "Error: checkpoints require the internal backing memory\n");
+
+  C.Section("RevMem");
+  C.Put<uint64_t>(memSize);
+  C.Put<uint64_t>(pageSize);
+  C.Put<uint64_t>(nextPage);
+  C.Put<uint64_t>(stacktop);
+  C.Put<uint32_t>(PIDCount);
+  C.Put(memStats);
+  C.PutVec(SCAttempts);
+  C.PutVec(SCFailures);
+  C.PutVec(std::vector<uint64_t>(FutureRes.begin(), FutureRes.end()));
+
+  // only the pages touched so far are written; physical pages are allocated densely
+  C.Put<uint64_t>(pageTable->GetNumMapped());
+  pageTable->ForEach([&](uint64_t VPN, const RevPTE &PTE){
+    C.Put<uint64_t>(VPN);
+    C.Put(PTE);
+  });
+
+  const uint64_t HostPage = (uint64_t)(sysconf(_SC_PAGESIZE));
+  const uint64_t Len = nextPage * pageSize;
+  C.AlignTo(HostPage);
+  C.PutBytes(physMem, Len);
+  C.AlignTo(HostPage);
+}
+
+void RevMem::Restore(RevCheckpoint &C){
+  if( !physMem )
+    output->fatal(CALL_INFO, -1, "Error: checkpoints require the internal backing memory\n");
+
+  C.Section("RevMem");
+  const uint64_t Size = C.Get<uint64_t>();
+  const uint64_t PageSize = C.Get<uint64_t>();
+  if( (Size != memSize) || (PageSize != pageSize) )
+    output->fatal(CALL_INFO, -1,
+                  "Error: checkpoint %s was taken with memSize=%" PRIu64 " pageSize=%" PRIu64
+                  "; this simulation uses memSize=%" PRIu64 " pageSize=%" PRIu64 "\n",
+                  C.GetName().c_str(), Size, PageSize, (uint64_t)(memSize), pageSize);
+  nextPage = C.Get<uint64_t>();
+  stacktop = C.Get<uint64_t>();
+  PIDCount = C.Get<uint32_t>();
+  memStats = C.Get<RevMemStats>();
+  SCAttempts = C.GetVec<uint64_t>();
+  SCFailures = C.GetVec<uint64_t>();
+  const std::vector<uint64_t> Futures = C.GetVec<uint64_t>();
+  FutureRes.clear();
+  FutureRes.insert(Futures.begin(), Futures.end());
+
+  // anything written by the loader is discarded along with its mappings
+  delete pageTable;
+  pageTable = new RevPageTable(64 - addrShift, _REVMEM_PT_BITS_, output);
+  const uint64_t NumMapped = C.Get<uint64_t>();
+  for( uint64_t i=0; i<NumMapped; i++ ){
+    const uint64_t VPN = C.Get<uint64_t>();
+    *pageTable->Walk(VPN) = C.Get<RevPTE>();
+    pageTable->MarkMapped();
+  }
+
+  // reservations and the modelled TLBs and caches restart cold
+  LRSC.assign(LRSC.size(), _INVALID_ADDR_);
+  LRSCLines.clear();
+  FlushTLB();
+  for( unsigned l=0; l<_REVMEM_CACHE_LEVELS_; l++ ){
+    for( unsigned i=0; i<Caches[l].size(); i++ )
+      Caches[l][i]->Flush();
+  }
+
+  // map the touched pages copy-on-write straight from the checkpoint and
+  // replace the rest of the backing memory with fresh zero-filled pages
+  const uint64_t HostPage = (uint64_t)(sysconf(_SC_PAGESIZE));
+  const uint64_t Off = C.AlignTo(HostPage);
+  const uint64_t Len = ((nextPage * pageSize) + HostPage - 1) & ~(HostPage - 1);
+  if( Len &&
+      mmap(physMem, Len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+           C.GetFD(), (off_t)(Off)) == MAP_FAILED )
+    output->fatal(CALL_INFO, -1, "Error: could not map the memory image from checkpoint %s\n",
+                  C.GetName().c_str());
+  if( Len < memSize ){
+    int mapFlags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED;
+#ifdef MAP_NORESERVE
+    mapFlags |= MAP_NORESERVE;
+#endif
+    if( mmap(physMem + Len, memSize - Len, PROT_READ | PROT_WRITE, mapFlags, -1, 0) == MAP_FAILED )
+      output->fatal(CALL_INFO, -1, "Error: could not reset the backing memory\n");
+  }
+  C.Skip(Len);
+}
+
+void RevMem::EnableHeatMap(const std::string &File, unsigned TopN){
+  if( heatFile )
+    fclose(heatFile);
+  heatFile = fopen(File.c_str(), "w");
+  if( !heatFile )
+    output->fatal(CALL_INFO, -1, "Error: could not open heat map file %s\n", File.c_str());
+  heatTop = TopN;
+  heatEpoch = curCycle;
+  fprintf(heatFile, "# W cycle working_set_pages working_set_bytes touched_pages shared_pages\n");
+  fprintf(heatFile, "# H cycle rank vaddr reads writes first_touch last_touch sharers core_mask interval_accesses\n");
+  fprintf(heatFile, "# S sharers pages\n");
+}
+
+void RevMem::DumpHeatMap(bool Final){
+  if( !heatFile )
+    return ;
+
+  // a single pass over the mapped pages gathers the interval and lifetime statistics
+  struct HotPage { uint64_t Accesses; uint64_t Interval; uint64_t VPN; const RevPTE *PTE; };
+  std::vector<HotPage> Hot;
+  std::vector<uint64_t> Sharers(65, 0);
+  uint64_t WorkingSet = 0;
+  uint64_t Touched = 0;
+  pageTable->ForEach([&](uint64_t VPN, RevPTE &PTE){
+    const uint64_t Lifetime = PTE.Reads + PTE.Writes;
+    if( Lifetime == 0 )
+      return ;
+    Touched++;
+    Sharers[__builtin_popcountll(PTE.Cores)]++;
+    // interval dumps rank the working set by the accesses made during the
+    // interval; the final dump ranks every page by its lifetime accesses
+    const uint64_t Interval = PTE.Interval;
+    PTE.Interval = 0;
+    if( PTE.LastTouch >= heatEpoch ){
+      WorkingSet++;
+      Hot.push_back({Final ? Lifetime : Interval, Interval, VPN, &PTE});
+    }else if( Final ){
+      Hot.push_back({Lifetime, Interval, VPN, &PTE});
+    }
+  });
+
+  const uint64_t Shared = Touched - Sharers[0] - Sharers[1];
+  fprintf(heatFile, "W %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 "\n",
+          curCycle, WorkingSet, WorkingSet * pageSize, Touched, Shared);
+
+  const size_t N = std::min(Hot.size(), (size_t)(heatTop));
+  std::partial_sort(Hot.begin(), Hot.begin() + N, Hot.end(),
+                    [](const HotPage &A, const HotPage &B){
+                      return (A.Accesses != B.Accesses) ? (A.Accesses > B.Accesses) : (A.VPN < B.VPN);
+                    });
+  for( size_t i=0; i<N; i++ ){
+    const RevPTE &P = *Hot[i].PTE;
+    fprintf(heatFile, "H %" PRIu64 " %zu 0x%" PRIx64 " %" PRIu64 " %" PRIu64 " %" PRIu64
+            " %" PRIu64 " %d 0x%" PRIx64 " %" PRIu64 "\n",
+            curCycle, i, Hot[i].VPN << addrShift, P.Reads, P.Writes, P.FirstTouch,
+            P.LastTouch, __builtin_popcountll(P.Cores), P.Cores, Hot[i].Interval);
+  }
+
+  if( Final ){
+    for( unsigned i=1; i<Sharers.size(); i++ ){
+      if( Sharers[i] )
+        fprintf(heatFile, "S %u %" PRIu64 "\n", i, Sharers[i]);
+    }
+    fflush(heatFile);
+  }
+  heatEpoch = curCycle + 1;
+}
+
+void RevMem::TraceAccess(uint64_t Addr, uint64_t Len, RevTraceOp Op, uint32_t Flags){
+  if( !trace->Filter(curCycle, Addr) )
+    return ;
+  RevTraceRecord R;
+  R.Cycle = curCycle;
+  R.Core  = activeCore;
+  R.Hart  = activeHart;
+  R.PC    = activePC;
+  R.VAddr = Addr;
+  // translate without touching the TLB so that tracing does not perturb its statistics
+  RevPTE *PTE = pageTable->Find(Addr >> addrShift);
+  R.PAddr = (PTE && (PTE->Flags & PTE_VALID)) ?
+            ((PTE->PPN << addrShift) | (Addr & (pageSize - 1))) : Addr;
+  R.Size  = (uint32_t)(Len);
+  R.Op    = Op;
+  R.Flags = Flags;
+  trace->Record(R);
+}
+
+void RevMem::CacheAccess(uint64_t Addr, uint64_t Len){
+  // the access is charged the latency of the slowest line it touches
+  const uint64_t LineSize = Caches[0].front()->GetLineSize();
+  const uint64_t End = Addr + (Len ? Len : 1);
+  lastLatency = 0;
+  lastMiss = false;
+  for( uint64_t Line = Addr & ~(LineSize-1); Line < End; Line += LineSize ){
+    unsigned Latency = 0;
+    bool Miss = true;
+    for( unsigned l=0; l<_REVMEM_CACHE_LEVELS_; l++ ){
+      if( Caches[l].empty() )
+        break;
+      RevCache *C = (Caches[l].size() == 1) ? Caches[l][0] : Caches[l][activeCore];
+      if( C->Access(Line) ){
+        CacheHits[l][activeCore]++;
+        Latency += C->GetHitLatency();
+        Miss = false;
+        break;
+      }
+      CacheMisses[l][activeCore]++;
+      Latency += C->GetMissLatency();
+    }
+    lastLatency = std::max(lastLatency, Latency);
+    lastMiss |= Miss;
+  }
+}
+
+void RevMem::AddMemRegion(const RevMemRegion &Region){
+  for( const RevRegionState &S : Regions ){
+    if( (Region.Base < S.Region.Base + S.Region.Size) &&
+        (S.Region.Base < Region.Base + Region.Size) )
+      output->fatal(CALL_INFO, -1,
+                    "Error: memory region at 0x%" PRIx64 " overlaps the region at 0x%" PRIx64 "\n",
+                    Region.Base, S.Region.Base);
+  }
+  RevRegionState S;
+  S.Region = Region;
+  S.BusyUntil = 0;
+  auto It = std::upper_bound(Regions.begin(), Regions.end(), Region.Base,
+                             [](uint64_t Base, const RevRegionState &R){ return Base < R.Region.Base; });
+  Regions.insert(It, S);
+  lastRegion = nullptr;
+
+  const unsigned numCores = std::max(opts->GetNumCores(), 1u);
+  if( RegionAccesses.size() < numCores ){
+    RegionAccesses.resize(numCores, 0);
+    RegionStalls.resize(numCores, 0);
+  }
+}
+
+bool RevMem::RegionAccess(uint64_t Addr, uint64_t Len){
+  // start from the last region whose base does not exceed the address; an
+  // access may also run into the regions that follow it
+  auto It = std::upper_bound(Regions.begin(), Regions.end(), Addr,
+                             [](uint64_t A, const RevRegionState &R){ return A < R.Region.Base; });
+  if( It != Regions.begin() )
+    --It;
+  const uint64_t End = Addr + std::max(Len, (uint64_t)(1));
+
+  // each region is charged only for the bytes that fall within it; the access
+  // takes the latency of the slowest region it touches
+  lastRegion = nullptr;
+  lastLatency = 0;
+  for( ; (It != Regions.end()) && (It->Region.Base < End); ++It ){
+    const uint64_t Lo = std::max(Addr, It->Region.Base);
+    const uint64_t Hi = std::min(Addr + Len, It->Region.Base + It->Region.Size);
+    if( Lo >= It->Region.Base + It->Region.Size )
+      continue;
+    if( !lastRegion || (It->Region.MaxCost > lastRegion->Region.MaxCost) )
+      lastRegion = &(*It);
+    RegionAccesses[activeCore]++;
+
+    // bandwidth-limited regions serialize transfers; a request waits for the
+    // previous transfer to drain and then occupies the region for Bytes/BW cycles
+    const uint64_t BW = It->Region.Bandwidth;
+    if( (BW != 0) && (Hi > Lo) ){
+      const uint64_t Start = std::max(curCycle, It->BusyUntil);
+      It->BusyUntil = Start + (Hi - Lo + BW - 1) / BW;
+      RegionStalls[activeCore] += Start - curCycle;
+      lastLatency = std::max(lastLatency, (unsigned)(Start - curCycle));
+    }
+  }
+  return lastRegion != nullptr;
+}
+
+void RevMem::SetPageSize(uint64_t PageSize){
+  if( nextPage != 0 )
+    output->fatal(CALL_INFO, -1,
+                  "Error: page size cannot be altered after pages have been allocated\n");
+  if( (PageSize < 8) || ((PageSize & (PageSize-1)) != 0) )
+    output->fatal(CALL_INFO, -1,
+                  "Error: page size must be a power of two of at least 8 bytes; pageSize=%" PRIu64 "\n", PageSize);
+  pageSize = PageSize;
+  addrShift = (unsigned)(__builtin_ctzll(PageSize));
+  delete pageTable;
+  pageTable = new RevPageTable(64 - addrShift, _REVMEM_PT_BITS_, output);
+  FlushTLB();
 }
 
 bool RevMem::outstandingRqsts(){
@@ -85,8 +451,8 @@ void RevMem::HandleMemFault(unsigned width){
   // find an address to fault
   std::random_device rd; // obtain a random number from hardware
   std::mt19937 gen(rd()); // seed the generator
-  std::uniform_int_distribution<> distr(0, memSize-8); // define the range
-  unsigned NBytes = distr(gen);
+  std::uniform_int_distribution<uint64_t> distr(0, memSize-8); // define the range
+  uint64_t NBytes = distr(gen);
   uint64_t *Addr = (uint64_t *)(&physMem[0] + NBytes);
 
   // write the fault (read-modify-write)
@@ -97,50 +463,123 @@ void RevMem::HandleMemFault(unsigned width){
 }
 
 bool RevMem::SetFuture(uint64_t Addr){
-  FutureRes.push_back(Addr);
-  std::sort( FutureRes.begin(), FutureRes.end() );
-  FutureRes.erase( std::unique( FutureRes.begin(), FutureRes.end() ), FutureRes.end() );
+  FutureRes.insert(Addr);
   return true;
 }
 
 bool RevMem::RevokeFuture(uint64_t Addr){
-  for( unsigned i=0; i<FutureRes.size(); i++ ){
-    if( FutureRes[i] == Addr ){
-      FutureRes.erase( FutureRes.begin() + i );
-      return true;
+  return (FutureRes.erase(Addr) != 0);
+}
+
+bool RevMem::StatusFuture(uint64_t Addr){
+  return (FutureRes.count(Addr) != 0);
+}
+
+void RevMem::ClearLRSC(unsigned Hart){
+  if( (Hart >= LRSC.size()) || (LRSC[Hart] == _INVALID_ADDR_) )
+    return ;
+  auto it = LRSCLines.find(LRSC[Hart]);
+  if( it != LRSCLines.end() ){
+    if( --(it->second) == 0 )
+      LRSCLines.erase(it);
+  }
+  LRSC[Hart] = _INVALID_ADDR_;
+}
+
+void RevMem::InvalidateLRSCLines(uint64_t Addr, uint64_t Len){
+  const uint64_t Mask = ~((uint64_t)(_REVMEM_LRSC_GRANULE_) - 1);
+  const uint64_t Last = (Addr + (Len ? Len-1 : 0)) & Mask;
+  for( uint64_t Line = Addr & Mask; Line <= Last; Line += _REVMEM_LRSC_GRANULE_ ){
+    if( LRSCLines.find(Line) == LRSCLines.end() )
+      continue;
+    // a store from any other hart breaks the reservation
+    for( unsigned h=0; h<LRSC.size(); h++ ){
+      if( (LRSC[h] == Line) && (h != activeCore) )
+        ClearLRSC(h);
     }
+    if( LRSCLines.empty() )
+      return ;
   }
-  // nothing found
-  return false;
 }
 
-bool RevMem::StatusFuture(uint64_t Addr){
-  for( unsigned i=0; i<FutureRes.size(); i++ ){
-    if( FutureRes[i] == Addr )
-      return true;
+bool RevMem::AMOMem( uint64_t Addr, size_t Len, void *Data, void *Target,
+                     StandardMem::Request::flags_t flags ){
+  if( (Len != 4) && (Len != 8) )
+    output->fatal(CALL_INFO, -1, "Error: unsupported AMO size of %zu bytes\n", Len);
+  if( (Addr & (Len-1)) != 0 )
+    output->fatal(CALL_INFO, -1, "Error: misaligned AMO at address 0x%" PRIx64 "\n", Addr);
+
+  // the AMO is a store as far as other harts' reservations are concerned
+  if( !FutureRes.empty() )
+    RevokeFuture(Addr);
+  InvalidateLRSC(Addr, Len);
+
+  if( ctrl ){
+    // issue the AMO as a single locked transaction through RevMemCtrl
+    char *BaseMem = &physMem[CalcPhysAddr(Addr >> addrShift, Addr)];
+    ctrl->sendAMORequest(Addr, (uint64_t)(BaseMem), (uint32_t)(Len),
+                         (char *)(Data), Target, flags);
+  }else if( Len == 4 ){
+    uint32_t *Mem = (uint32_t *)(HostAddr(Addr));
+    uint32_t Val = 0;
+    std::memcpy(&Val, Data, sizeof(uint32_t));
+    uint32_t Old = __atomic_load_n(Mem, __ATOMIC_ACQUIRE);
+    while( !__atomic_compare_exchange_n(Mem, &Old, RevAMOCompute(Old, Val, flags),
+                                        false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) ){
+    }
+    if( (uint32_t)(flags) & (uint32_t)(RevCPU::RevFlag::F_SEXT64) ){
+      uint64_t Ext = (uint64_t)((int64_t)((int32_t)(Old)));
+      std::memcpy(Target, &Ext, sizeof(uint64_t));
+    }else{
+      std::memcpy(Target, &Old, sizeof(uint32_t));
+    }
+  }else{
+    uint64_t *Mem = (uint64_t *)(HostAddr(Addr));
+    uint64_t Val = 0;
+    std::memcpy(&Val, Data, sizeof(uint64_t));
+    uint64_t Old = __atomic_load_n(Mem, __ATOMIC_ACQUIRE);
+    while( !__atomic_compare_exchange_n(Mem, &Old, RevAMOCompute(Old, Val, flags),
+                                        false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) ){
+    }
+    std::memcpy(Target, &Old, sizeof(uint64_t));
   }
-  return false;
+
+  memStats.bytesRead += Len;
+  memStats.bytesWritten += Len;
+  NoteAccess(Addr, Len, RevTraceOp::AMO, (uint32_t)(flags));
+  return true;
 }
 
 bool RevMem::LR(unsigned Hart, uint64_t Addr){
-  std::pair<unsigned,uint64_t> Entry = std::make_pair(Hart,Addr);
-  LRSC.push_back(Entry);
+  if( Hart >= LRSC.size() ){
+    LRSC.resize(Hart+1, _INVALID_ADDR_);
+    SCAttempts.resize(Hart+1, 0);
+    SCFailures.resize(Hart+1, 0);
+  }
+
+  // each hart holds at most one reservation
+  ClearLRSC(Hart);
+  const uint64_t Line = Addr & ~((uint64_t)(_REVMEM_LRSC_GRANULE_) - 1);
+  LRSC[Hart] = Line;
+  LRSCLines[Line]++;
   return true;
 }
 
 bool RevMem::SC(unsigned Hart, uint64_t Addr){
-  // search the LRSC vector for the entry pair
-  std::vector<std::pair<unsigned,uint64_t>>::iterator it;
-
-  for( it = LRSC.begin(); it != LRSC.end(); ++it ){
-    if( (Hart == std::get<0>(*it)) &&
-        (Addr == std::get<1>(*it)) ){
-      LRSC.erase(it);
-      return true;
-    }
+  if( Hart >= LRSC.size() ){
+    SCAttempts.resize(Hart+1, 0);
+    SCFailures.resize(Hart+1, 0);
+    LRSC.resize(Hart+1, _INVALID_ADDR_);
   }
+  SCAttempts[Hart]++;
 
-  return false;
+  // the reservation is consumed whether or not the store conditional succeeds
+  const uint64_t Line = Addr & ~((uint64_t)(_REVMEM_LRSC_GRANULE_) - 1);
+  const bool Held = (LRSC[Hart] == Line);
+  ClearLRSC(Hart);
+  if( !Held )
+    SCFailures[Hart]++;
+  return Held;
 }
 
 unsigned RevMem::RandCost( unsigned Min, unsigned Max ){
@@ -154,86 +593,62 @@ unsigned RevMem::RandCost( unsigned Min, unsigned Max ){
 }
 
 void RevMem::FlushTLB(){
-  TLB.clear();
-  LRUQueue.clear();
-  return;
-}
-
-uint64_t RevMem::SearchTLB(uint64_t vAddr){
-  auto it = TLB.find(vAddr);
-  if (it == TLB.end()) {
-      // TLB Miss :(
-      memStats.TLBMisses++;
-      return _INVALID_ADDR_;
-  } else {
-    memStats.TLBHits++;
-    // Move the accessed vAddr to the front of the LRU list
-    LRUQueue.erase(it->second.second);
-    LRUQueue.push_front(vAddr);
-    // Update the second of the pair in the tlbMap to point to the new location in LRU list
-    it->second.second = LRUQueue.begin();
-    // Return the physAddr
-    return it->second.first;
-  }
-}
-
-void RevMem::AddToTLB(uint64_t vAddr, uint64_t physAddr){
-  auto it = TLB.find(vAddr);
-  if (it != TLB.end()) {
-    // If the vAddr is already present in the TLB,
-    // then this is a page update, not a miss
-    // Move the vAddr to the front of LRU list
-    LRUQueue.erase(it->second.second);
-    LRUQueue.push_front(vAddr);
-    // Update the pair in the TLB
-    it->second.first = physAddr;
-    it->second.second = LRUQueue.begin();
-  } else {
-    // If cache is full, remove the least recently used
-    // vAddr from both cache and LRU list
-    if (LRUQueue.size() == tlbSize) {
-      uint64_t LRUvAddr = LRUQueue.back();
-      LRUQueue.pop_back();
-      TLB.erase(LRUvAddr);
-    }
-    // Insert the vAddr and physAddr into the TLB and LRU list
-    LRUQueue.push_front(vAddr);
-    TLB.insert({vAddr, {physAddr, LRUQueue.begin()}});
+  for( unsigned i=0; i<TLBs.size(); i++ )
+    TLBs[i]->Flush();
+  for( unsigned i=0; i<HostTLB.size(); i++ ){
+    HostTLB[i].VPN = _INVALID_ADDR_;
+    HostTLB[i].Host = nullptr;
+    HostTLB[i].Slot = 0;
   }
+  return;
 }
 
 uint64_t RevMem::CalcPhysAddr(uint64_t pageNum, uint64_t vAddr){
-  uint64_t physAddr = SearchTLB(vAddr);
-  if( physAddr == _INVALID_ADDR_ ){
-    if(pageMap.count(pageNum) == 0){
-      // First touch of this page, mark it as in use
-      pageMap[pageNum] = std::pair<uint32_t, bool>(nextPage, true);
-      physAddr = (nextPage << addrShift) + ((pageSize - 1) & vAddr);
+  uint64_t physPage = activeTLB->Lookup(pageNum);
+  if( physPage != _INVALID_ADDR_ ){
+    memStats.TLBHits++;
+  }else{
+    memStats.TLBMisses++;
+    RevPTE *PTE = pageTable->Walk(pageNum);
+    if( !(PTE->Flags & PTE_VALID) ){
+      // First touch of this page, mark it as in use; the whole page
+      // must lie inside physMem since it is accessed through host pointers
+      if( ((nextPage + 1) << addrShift) > memSize )
+        output->fatal(CALL_INFO, -1,
+                      "Error: out of physical memory mapping page 0x%" PRIx64 "; memSize=%" PRIu64 " pageSize=%" PRIu64 "\n",
+                      pageNum, (uint64_t)(memSize), pageSize);
+      PTE->PPN = nextPage;
+      PTE->Flags |= PTE_VALID;
+      pageTable->MarkMapped();
 #ifdef _REV_DEBUG_
       std::cout << "First Touch for page:" << pageNum << " addrShift:"
                 << addrShift << " vAddr: 0x" << std::hex << vAddr
-                << " PhsyAddr: 0x" << physAddr << std::dec << " Next Page: "
-                << nextPage << std::endl;
+                << std::dec << " Next Page: " << nextPage << std::endl;
 #endif
       nextPage++;
-    }else if(pageMap.count(pageNum) == 1){
-      //We've accessed this page before, just get the physical address
-      physAddr = (pageMap[pageNum].first << addrShift) + ((pageSize - 1) & vAddr);
-#ifdef _REV_DEBUG_
-      std::cout << "Access for page:" << pageNum << " addrShift:"
-                << addrShift << " vAddr: 0x" << std::hex << vAddr
-                << " PhsyAddr: 0x" << physAddr << std::dec << " Next Page: "
-                << nextPage << std::endl;
-#endif
-    }else{
-      output->fatal(CALL_INFO, -1, "Error: Page allocated multiple times");
     }
-    AddToTLB(vAddr, physAddr);
+    physPage = PTE->PPN;
+    const uint64_t Evicted = activeTLB->Insert(pageNum, physPage);
+    if( Evicted != _INVALID_ADDR_ ){
+      RevHostTLBEntry &E = activeHostTLB[Evicted & (_REVMEM_HOSTTLB_ENTRIES_ - 1)];
+      if( E.VPN == Evicted )
+        E.VPN = _INVALID_ADDR_;
+    }
   }
-  return physAddr;
+
+  if( physMem ){
+    // refill the host translation cache for the internal memory path
+    RevHostTLBEntry &E = activeHostTLB[pageNum & (_REVMEM_HOSTTLB_ENTRIES_ - 1)];
+    E.VPN = pageNum;
+    E.Host = &physMem[physPage << addrShift];
+    E.Slot = activeTLB->Find(pageNum);
+  }
+  return (physPage << addrShift) + ((pageSize - 1) & vAddr);
 }
 
 bool RevMem::FenceMem(){
+  if( trace )
+    TraceAccess(0, 0, RevTraceOp::FENCE, 0);
   if( ctrl ){
     return ctrl->sendFENCE();
   }
@@ -249,198 +664,62 @@ bool RevMem::WriteMem( uint64_t Addr, size_t Len, void *Data,
   if(Addr == 0xDEADBEEF){
     std::cout << "Found special write. Val = " << std::hex << *(int*)(Data) << std::dec << std::endl;
   }
-  RevokeFuture(Addr); // revoke the future if it is present; ignore the return
-  uint64_t pageNum = Addr >> addrShift;
-  uint64_t physAddr = CalcPhysAddr(pageNum, Addr);
-
-  //check to see if we're about to walk off the page....
-  uint32_t adjPageNum = 0;
-  uint64_t adjPhysAddr = 0;
-  uint64_t endOfPage = (pageMap[pageNum].first << addrShift) + pageSize;
-  char *BaseMem = &physMem[physAddr];
+  if( !FutureRes.empty() )
+    RevokeFuture(Addr); // revoke the future if it is present; ignore the return
+  InvalidateLRSC(Addr, Len);
+
+  // split the request at each page boundary; every span is
+  // translated separately as the physical pages need not be contiguous
   char *DataMem = (char *)(Data);
-  if((physAddr + Len) > endOfPage){
-    uint32_t span = (physAddr + Len) - endOfPage;
-    adjPageNum = ((Addr+Len)-span) >> addrShift;
-    adjPhysAddr = CalcPhysAddr(adjPageNum, ((Addr+Len)-span));
+  uint64_t Cur = 0;
+  while( Cur < Len ){
+    const uint64_t VAddr = Addr + Cur;
+    const uint64_t span = std::min((uint64_t)(Len) - Cur,
+                                   pageSize - (VAddr & (pageSize - 1)));
+    char *BaseMem = ctrl ? &physMem[CalcPhysAddr(VAddr >> addrShift, VAddr)] : HostAddr(VAddr);
 #ifdef _REV_DEBUG_
-    std::cout << "Warning: Writing off end of page... " << std::endl;
+    if( span != Len )
+      std::cout << "Warning: Writing off end of page... " << std::endl;
 #endif
-    if( ctrl ){
-      ctrl->sendWRITERequest(Addr,
-                             (uint64_t)(BaseMem),
-                             Len,
-                             DataMem,
-                             flags);
-    }else{
-      for( unsigned i=0; i< (Len-span); i++ ){
-        BaseMem[i] = DataMem[i];
-      }
-    }
-    BaseMem = &physMem[adjPhysAddr];
     if( ctrl ){
       // write the memory using RevMemCtrl
-      unsigned Cur = (Len-span);
-      ctrl->sendWRITERequest(Addr,
+      ctrl->sendWRITERequest(VAddr,
                              (uint64_t)(BaseMem),
-                             Len,
-                             &(DataMem[Cur]),
+                             span,
+                             &DataMem[Cur],
                              flags);
     }else{
       // write the memory using the internal RevMem model
-      unsigned Cur = (Len-span);
-      for( unsigned i=0; i< span; i++ ){
-        BaseMem[i] = DataMem[Cur];
-        Cur++;
-      }
-    }
-  }else{
-    if( ctrl ){
-      // write the memory using RevMemCtrl
-      ctrl->sendWRITERequest(Addr,
-                             (uint64_t)(BaseMem),
-                             Len,
-                             DataMem,
-                             flags);
-    }else{
-      // write the memory using the internal RevMem model
-      for( unsigned i=0; i<Len; i++ ){
-        BaseMem[i] = DataMem[i];
-      }
+      std::memcpy(BaseMem, &DataMem[Cur], span);
     }
+    Cur += span;
   }
   memStats.bytesWritten += Len;
+  NoteAccess(Addr, Len, RevTraceOp::WRITE, (uint32_t)(flags));
   return true;
 }
 
-
 bool RevMem::WriteMem( uint64_t Addr, size_t Len, void *Data ){
-#ifdef _REV_DEBUG_
-  std::cout << "Writing " << Len << " Bytes Starting at 0x" << std::hex << Addr << std::dec << std::endl;
-#endif
-
-  if(Addr == 0xDEADBEEF){
-    std::cout << "Found special write. Val = " << std::hex << *(int*)(Data) << std::dec << std::endl;
-  }
-  RevokeFuture(Addr); // revoke the future if it is present; ignore the return
-  uint64_t pageNum = Addr >> addrShift;
-  uint64_t physAddr = CalcPhysAddr(pageNum, Addr);
-
-  //check to see if we're about to walk off the page....
-  uint32_t adjPageNum = 0;
-  uint64_t adjPhysAddr = 0;
-  uint64_t endOfPage = (pageMap[pageNum].first << addrShift) + pageSize;
-  char *BaseMem = &physMem[physAddr];
-  char *DataMem = (char *)(Data);
-  if((physAddr + Len) > endOfPage){
-    uint32_t span = (physAddr + Len) - endOfPage;
-    adjPageNum = ((Addr+Len)-span) >> addrShift;
-    adjPhysAddr = CalcPhysAddr(adjPageNum, ((Addr+Len)-span));
-
-#ifdef _REV_DEBUG_
-    std::cout << "ENDOFPAGE = " << std::hex << endOfPage << std::dec << std::endl;
-    for( unsigned i=0; i<(Len-span); i++ ){
-        std::cout << "WRITE TO: " << std::hex << (uint64_t)(&BaseMem[i]) << std::dec
-                  << "; FROM LOGICAL PHYS=" << std::hex << physAddr + i << std::dec
-                  << "; DATA=" << std::hex << (uint8_t)(BaseMem[i]) << std::dec
-                  << "; VIRTUAL ADDR=" << std::hex << Addr+i << std::dec << std::endl;
-    }
-
-    std::cout << "TOTAL WRITE = " << Len << " Bytes" << std::endl;
-    std::cout << "PHYS Writing " << Len-span << " Bytes Starting at 0x" << std::hex << physAddr << std::dec
-              << "; translates to: " << std::hex << (uint64_t)(BaseMem) << std::dec << std::endl;
-    std::cout << "ADJ PHYS Writing " << span << " Bytes Starting at 0x" << std::hex << adjPhysAddr << std::dec
-              << "; translates to: " << std::hex << (uint64_t)(&physMem[adjPhysAddr]) << std::dec << std::endl;
-    std::cout << "Warning: Writing off end of page... " << std::endl;
-#endif
-    if( ctrl ){
-      ctrl->sendWRITERequest(Addr,
-                             (uint64_t)(BaseMem),
-                             Len,
-                             DataMem,
-                             0x00);
-    }else{
-      for( unsigned i=0; i< (Len-span); i++ ){
-        BaseMem[i] = DataMem[i];
-      }
-    }
-    BaseMem = &physMem[adjPhysAddr];
-    if( ctrl ){
-      // write the memory using RevMemCtrl
-      unsigned Cur = (Len-span);
-      ctrl->sendWRITERequest(Addr,
-                             (uint64_t)(BaseMem),
-                             Len,
-                             &(DataMem[Cur]),
-                             0x00);
-    }else{
-      // write the memory using the internal RevMem model
-      unsigned Cur = (Len-span);
-      for( unsigned i=0; i< span; i++ ){
-        BaseMem[i] = DataMem[Cur];
-#ifdef _REV_DEBUG_
-        std::cout << "ADJ WRITE TO: " << std::hex << (uint64_t)(&BaseMem[i]) << std::dec
-                  << "; FROM LOGICAL PHYS=" << std::hex << adjPhysAddr + i << std::dec
-                  << "; DATA=" << std::hex << (uint8_t)(BaseMem[i]) << std::dec
-                  << "; VIRTUAL ADDR=" << std::hex << Addr+Cur << std::dec << std::endl;
-#endif
-        Cur++;
-      }
-    }
-  }else{
-    if( ctrl ){
-      // write the memory using RevMemCtrl
-      ctrl->sendWRITERequest(Addr,
-                             (uint64_t)(BaseMem),
-                             Len,
-                             DataMem,
-                             0x00);
-    }else{
-      // write the memory using the internal RevMem model
-      for( unsigned i=0; i<Len; i++ ){
-        BaseMem[i] = DataMem[i];
-      }
-    }
-  }
-  memStats.bytesWritten += Len;
-  return true;
+  return WriteMem(Addr, Len, Data, 0x00);
 }
 
 bool RevMem::ReadMem( uint64_t Addr, size_t Len, void *Data ){
 #ifdef _REV_DEBUG_
   std::cout << "OLD READMEM: Reading " << Len << " Bytes Starting at 0x" << std::hex << Addr << std::dec << std::endl;
 #endif
-  uint64_t pageNum = Addr >> addrShift;
-  uint64_t physAddr = CalcPhysAddr(pageNum, Addr);
-
-  //check to see if we're about to walk off the page....
-  uint32_t adjPageNum = 0;
-  uint64_t adjPhysAddr = 0;
-  uint64_t endOfPage = (pageMap[pageNum].first << addrShift) + pageSize;
-  char *BaseMem = &physMem[physAddr];
+  // the deprecated interface always reads the internal memory directly
   char *DataMem = (char *)(Data);
-  if((physAddr + Len) > endOfPage){
-    uint32_t span = (physAddr + Len) - endOfPage;
-    adjPageNum = ((Addr+Len)-span) >> addrShift;
-    adjPhysAddr = CalcPhysAddr(adjPageNum, ((Addr+Len)-span));
-    for( unsigned i=0; i< (Len-span); i++ ){
-      DataMem[i] = BaseMem[i];
-    }
-    BaseMem = &physMem[adjPhysAddr];
-    unsigned Cur = (Len-span);
-    for( unsigned i=0; i< span; i++ ){
-      DataMem[Cur] = BaseMem[i];
-    }
-#ifdef _REV_DEBUG_
-    std::cout << "Warning: Reading off end of page... " << std::endl;
-#endif
-  }else{
-    for( unsigned i=0; i<Len; i++ ){
-      DataMem[i] = BaseMem[i];
-    }
+  uint64_t Cur = 0;
+  while( Cur < Len ){
+    const uint64_t VAddr = Addr + Cur;
+    const uint64_t span = std::min((uint64_t)(Len) - Cur,
+                                   pageSize - (VAddr & (pageSize - 1)));
+    std::memcpy(&DataMem[Cur], HostAddr(VAddr), span);
+    Cur += span;
   }
 
   memStats.bytesRead += Len;
+  NoteAccess(Addr, Len, RevTraceOp::READ, 0);
   return true;
 }
 
@@ -449,50 +728,27 @@ bool RevMem::ReadMem(uint64_t Addr, size_t Len, void *Target,
 #ifdef _REV_DEBUG_
   std::cout << "NEW READMEM: Reading " << Len << " Bytes Starting at 0x" << std::hex << Addr << std::dec << std::endl;
 #endif
-  uint64_t pageNum = Addr >> addrShift;
-  uint64_t physAddr = CalcPhysAddr(pageNum, Addr);
-  //check to see if we're about to walk off the page....
-  uint32_t adjPageNum = 0;
-  uint64_t adjPhysAddr = 0;
-  uint64_t endOfPage = (pageMap[pageNum].first << addrShift) + pageSize;
-  char *BaseMem = &physMem[physAddr];
   char *DataMem = (char *)(Target);
-  if((physAddr + Len) > endOfPage){
-    uint32_t span = (physAddr + Len) - endOfPage;
-    adjPageNum = ((Addr+Len)-span) >> addrShift;
-    adjPhysAddr = CalcPhysAddr(adjPageNum, ((Addr+Len)-span));
-    if( ctrl ){
-      ctrl->sendREADRequest(Addr, (uint64_t)(BaseMem), Len, Target, flags);
-    }else{
-      for( unsigned i=0; i< (Len-span); i++ ){
-        DataMem[i] = BaseMem[i];
-      }
-    }
-    BaseMem = &physMem[adjPhysAddr];
-    if( ctrl ){
-      unsigned Cur = (Len-span);
-      ctrl->sendREADRequest(Addr, (uint64_t)(BaseMem), Len, ((char*)Target)+Cur, flags);
-    }else{
-      unsigned Cur = (Len-span);
-      for( unsigned i=0; i< span; i++ ){
-        DataMem[Cur] = BaseMem[i];
-        Cur++;
-      }
-    }
+  uint64_t Cur = 0;
+  while( Cur < Len ){
+    const uint64_t VAddr = Addr + Cur;
+    const uint64_t span = std::min((uint64_t)(Len) - Cur,
+                                   pageSize - (VAddr & (pageSize - 1)));
+    char *BaseMem = ctrl ? &physMem[CalcPhysAddr(VAddr >> addrShift, VAddr)] : HostAddr(VAddr);
 #ifdef _REV_DEBUG_
-    std::cout << "Warning: Reading off end of page... " << std::endl;
+    if( span != Len )
+      std::cout << "Warning: Reading off end of page... " << std::endl;
 #endif
-  }else{
     if( ctrl ){
-      ctrl->sendREADRequest(Addr, (uint64_t)(BaseMem), Len, Target, flags);
+      ctrl->sendREADRequest(VAddr, (uint64_t)(BaseMem), span, &DataMem[Cur], flags);
     }else{
-      for( unsigned i=0; i<Len; i++ ){
-        DataMem[i] = BaseMem[i];
-      }
+      std::memcpy(&DataMem[Cur], BaseMem, span);
     }
+    Cur += span;
   }
 
   memStats.bytesRead += Len;
+  NoteAccess(Addr, Len, RevTraceOp::READ, (uint32_t)(flags));
   return true;
 }
 
@@ -545,26 +801,22 @@ double RevMem::ReadDouble( uint64_t Addr ){
 }
 
 void RevMem::WriteU8( uint64_t Addr, uint8_t Value ){
-  uint8_t Tmp = Value;
-  if( !WriteMem(Addr,1,(void *)(&Tmp)) )
+  if( !WriteVal(Addr, Value, 0x00) )
     output->fatal(CALL_INFO, -1, "Error: could not write memory (U8)");
 }
 
 void RevMem::WriteU16( uint64_t Addr, uint16_t Value ){
-  uint16_t Tmp = Value;
-  if( !WriteMem(Addr,2,(void *)(&Tmp)) )
+  if( !WriteVal(Addr, Value, 0x00) )
     output->fatal(CALL_INFO, -1, "Error: could not write memory (U16)");
 }
 
 void RevMem::WriteU32( uint64_t Addr, uint32_t Value ){
-  uint32_t Tmp = Value;
-  if( !WriteMem(Addr,4,(void *)(&Tmp)) )
+  if( !WriteVal(Addr, Value, 0x00) )
     output->fatal(CALL_INFO, -1, "Error: could not write memory (U32)");
 }
 
 void RevMem::WriteU64( uint64_t Addr, uint64_t Value ){
-  uint64_t Tmp = Value;
-  if( !WriteMem(Addr,8,(void *)(&Tmp)) )
+  if( !WriteVal(Addr, Value, 0x00) )
     output->fatal(CALL_INFO, -1, "Error: could not write memory (U64)");
 }
 
@@ -572,7 +824,7 @@ void RevMem::WriteFloat( uint64_t Addr, float Value ){
   uint32_t Tmp = 0x00;
   std::memcpy(&Tmp,&Value,sizeof(float));
   memStats.floatsWritten++;
-  if( !WriteMem(Addr,4,(void *)(&Tmp)) )
+  if( !WriteVal(Addr, Tmp, 0x00) )
     output->fatal(CALL_INFO, -1, "Error: could not write memory (FLOAT)");
 }
 
@@ -580,7 +832,7 @@ void RevMem::WriteDouble( uint64_t Addr, double Value ){
   uint64_t Tmp = 0x00;
   std::memcpy(&Tmp,&Value,sizeof(double));
   memStats.doublesWritten++;
-  if( !WriteMem(Addr,8,(void *)(&Tmp)) )
+  if( !WriteVal(Addr, Tmp, 0x00) )
     output->fatal(CALL_INFO, -1, "Error: could not write memory (DOUBLE)");
 }
 
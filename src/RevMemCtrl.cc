@@ -9,6 +9,7 @@
 //
 
 #include "../include/RevMemCtrl.h"
+#include <cstring>
 
 using namespace SST;
 using namespace RevCPU;
@@ -19,30 +20,36 @@ using namespace RevCPU;
 RevMemOp::RevMemOp(uint64_t Addr, uint64_t PAddr, uint32_t Size,
                    RevMemOp::MemOp Op, StandardMem::Request::flags_t flags )
   : Addr(Addr), PAddr(PAddr), Size(Size), Inv(false), Op(Op), CustomOpc(0),
-    SplitRqst(1), flags(flags), target(nullptr){
+    SplitRqst(1), SplitLeft(1), flags(flags), target(nullptr){
 }
 
 RevMemOp::RevMemOp(uint64_t Addr, uint64_t PAddr, uint32_t Size, void *target,
                    RevMemOp::MemOp Op, StandardMem::Request::flags_t flags )
   : Addr(Addr), PAddr(PAddr), Size(Size), Inv(false), Op(Op), CustomOpc(0),
-    SplitRqst(1), flags(flags), target(target){
+    SplitRqst(1), SplitLeft(1), flags(flags), target(target){
 }
 
 RevMemOp::RevMemOp(uint64_t Addr, uint64_t PAddr, uint32_t Size,
                    char *buffer, RevMemOp::MemOp Op,
                    StandardMem::Request::flags_t flags )
   : Addr(Addr), PAddr(PAddr), Size(Size), Inv(false), Op(Op), CustomOpc(0),
-    SplitRqst(1), flags(flags), target(nullptr){
-  for(unsigned i=0; i<(unsigned)(Size); i++ ){
-    membuf.push_back((uint8_t)(buffer[i]));
-  }
+    SplitRqst(1), SplitLeft(1), flags(flags), target(nullptr){
+  setBuf(buffer);
+}
+
+RevMemOp::RevMemOp(uint64_t Addr, uint64_t PAddr, uint32_t Size,
+                   char *buffer, void *target, RevMemOp::MemOp Op,
+                   StandardMem::Request::flags_t flags )
+  : Addr(Addr), PAddr(PAddr), Size(Size), Inv(false), Op(Op), CustomOpc(0),
+    SplitRqst(1), SplitLeft(1), flags(flags), target(target){
+  setBuf(buffer);
 }
 
 RevMemOp::RevMemOp(uint64_t Addr, uint64_t PAddr, uint32_t Size,
                    void *target, unsigned CustomOpc, RevMemOp::MemOp Op,
                    StandardMem::Request::flags_t flags )
   : Addr(Addr), PAddr(PAddr), Size(Size), Inv(false), Op(Op),
-    CustomOpc(CustomOpc), SplitRqst(1), flags(flags),
+    CustomOpc(CustomOpc), SplitRqst(1), SplitLeft(1), flags(flags),
     target(target){
 }
 
@@ -50,20 +57,50 @@ RevMemOp::RevMemOp(uint64_t Addr, uint64_t PAddr, uint32_t Size, char *buffer,
                    unsigned CustomOpc, RevMemOp::MemOp Op,
                    StandardMem::Request::flags_t flags )
   : Addr(Addr), PAddr(PAddr), Size(Size), Inv(false), Op(Op),
-    CustomOpc(CustomOpc), SplitRqst(1), flags(flags), target(nullptr){
-  for(unsigned i=0; i<(unsigned)(Size); i++ ){
-    membuf.push_back((uint8_t)(buffer[i]));
-  }
+    CustomOpc(CustomOpc), SplitRqst(1), SplitLeft(1), flags(flags), target(nullptr){
+  setBuf(buffer);
 }
 
 RevMemOp::~RevMemOp(){
 }
 
+void RevMemOp::setBuf(const char *buffer){
+  if( Size <= _REV_MEMOP_INLINE_ ){
+    std::memcpy(inlineBuf, buffer, Size);
+  }else{
+    membuf.assign((const uint8_t *)(buffer), (const uint8_t *)(buffer) + Size);
+  }
+}
+
+// Released ops are threaded through their own storage onto a per-thread
+// free list.  A RevMemOp is created and destroyed for every memory request,
+// so recycling them keeps the general purpose heap out of the request path.
+static thread_local void *MemOpFreeList = nullptr;
+
+void *RevMemOp::operator new(size_t Sz){
+  if( (Sz != sizeof(RevMemOp)) || (MemOpFreeList == nullptr) )
+    return ::operator new(Sz);
+  void *P = MemOpFreeList;
+  MemOpFreeList = *(void **)(P);
+  return P;
+}
+
+void RevMemOp::operator delete(void *P, size_t Sz){
+  if( P == nullptr )
+    return ;
+  if( Sz != sizeof(RevMemOp) ){
+    ::operator delete(P);
+    return ;
+  }
+  *(void **)(P) = MemOpFreeList;
+  MemOpFreeList = P;
+}
+
 // ---------------------------------------------------------------
 // RevMemCtrl
 // ---------------------------------------------------------------
 RevMemCtrl::RevMemCtrl(ComponentId_t id, Params& params)
-  : SubComponent(id), output(nullptr) {
+  : SubComponent(id), output(nullptr), activePC(0), activeCore(0) {
 
   uint32_t verbosity = params.find<uint32_t>("verbose");
   output = new SST::Output("[RevMemCtrl @t]: ", verbosity, 0, SST::Output::STDOUT);
@@ -77,13 +114,23 @@ RevMemCtrl::~RevMemCtrl(){
 // ---------------------------------------------------------------
 // RevBasicMemCtrl
 // ---------------------------------------------------------------
+
+/// op class names for the queueing delay and latency statistics; indexed by RevMemOp::MemOp
+static const char *LatClassNames[_REV_LAT_CLASSES_] = {
+  "Read", "Write", "Flush", "ReadLock", "WriteUnlock", "LoadLink", "StoreCond", "Custom"
+};
+
 RevBasicMemCtrl::RevBasicMemCtrl(ComponentId_t id, Params& params)
-  : RevMemCtrl(id,params), memIface(nullptr), stdMemHandlers(nullptr),
+  : RevMemCtrl(id,params), memIface(nullptr), instIface(nullptr), stdMemHandlers(nullptr),
     hasCache(false), lineSize(0),
     max_loads(64), max_stores(64), max_flush(64), max_llsc(64),
     max_readlock(64), max_writeunlock(64), max_custom(64), max_ops(2),
+    coalesceLoads(false), wbufEntries(0), wbufDrainAge(16), curCycle(0),
+    timeConverter(nullptr), clockHandler(nullptr), clockActive(false),
     num_read(0), num_write(0), num_flush(0), num_llsc(0), num_readlock(0),
-    num_writeunlock(0), num_custom(0), num_fence(0){
+    num_writeunlock(0), num_custom(0), num_fence(0), rqstSeq(0), numQueued(0),
+    prefetcher(nullptr), pfQueueSize(32), pfIssued(0), pfUseful(0), pfLate(0),
+    pfDemand(0){
 
   stdMemHandlers = new RevBasicMemCtrl::RevStdMemHandlers(this,output);
 
@@ -97,8 +144,13 @@ RevBasicMemCtrl::RevBasicMemCtrl(ComponentId_t id, Params& params)
   max_writeunlock = params.find<unsigned>("max_writeunlock", 64);
   max_custom = params.find<unsigned>("max_custom", 64);
   max_ops = params.find<unsigned>("ops_per_cycle", 2);
+  coalesceLoads = params.find<bool>("coalesce_loads", false);
+  wbufEntries = params.find<unsigned>("wbuf_entries", 0);
+  wbufDrainAge = params.find<unsigned>("wbuf_drain_age", 16);
+  pfQueueSize = params.find<unsigned>("pf_queue", 32);
 
-  rqstQ.reserve(max_ops);
+  outstanding.reserve(max_loads + max_stores + max_flush + max_llsc +
+                      max_readlock + max_writeunlock + max_custom);
 
   memIface = loadUserSubComponent<Interfaces::StandardMem>(
     "memIface", ComponentInfo::SHARE_NONE,//*/ComponentInfo::SHARE_PORTS | ComponentInfo::INSERT_STATS,
@@ -109,17 +161,39 @@ RevBasicMemCtrl::RevBasicMemCtrl(ComponentId_t id, Params& params)
     output->fatal(CALL_INFO, -1, "Error : memory interface is null\n");
   }
 
+  // instruction fetch shares memIface unless a separate interface is loaded
+  instIface = loadUserSubComponent<Interfaces::StandardMem>(
+    "instIface", ComponentInfo::SHARE_NONE,
+    getTimeConverter(ClockFreq), new StandardMem::Handler<SST::RevCPU::RevBasicMemCtrl>(
+      this, &RevBasicMemCtrl::processMemEvent));
+
+  // the data prefetcher is optional
+  prefetcher = loadUserSubComponent<RevDataPrefetcher>("prefetcher");
+
   registerStats();
 
-  registerClock( ClockFreq,
-              new Clock::Handler<RevBasicMemCtrl>(this,&RevBasicMemCtrl::clockTick));
+  clockHandler = new Clock::Handler<RevBasicMemCtrl>(this,&RevBasicMemCtrl::clockTick);
+  timeConverter = registerClock( ClockFreq, clockHandler );
+  clockActive = true;
+}
+
+void RevBasicMemCtrl::wakeClock(){
+  // the cycle count kept running while the clock was released; resume
+  // timestamping from the next tick so queueing delays stay accurate
+  curCycle = reregisterClock(timeConverter, clockHandler);
+  clockActive = true;
 }
 
 RevBasicMemCtrl::~RevBasicMemCtrl(){
-  for( unsigned i=0; i<rqstQ.size(); i++ ){
-    delete rqstQ[i];
+  for( unsigned c=0; c<RqstNumClasses; c++ ){
+    for( auto &Q : rqstQ[c] )
+      delete Q.second;
+    rqstQ[c].clear();
+  }
+  for( auto &M : mshrWaiters ){
+    for( RevMemOp *op : M.second )
+      delete op;
   }
-  rqstQ.clear();
   delete stdMemHandlers;
 }
 
@@ -146,11 +220,54 @@ void RevBasicMemCtrl::registerStats(){
   stats.push_back(registerStatistic<uint64_t>("CustomPending"));
   stats.push_back(registerStatistic<uint64_t>("CustomBytes"));
   stats.push_back(registerStatistic<uint64_t>("FencePending"));
+  stats.push_back(registerStatistic<uint64_t>("ReadCoalesced"));
+  stats.push_back(registerStatistic<uint64_t>("MSHRLines"));
+  stats.push_back(registerStatistic<uint64_t>("WriteBufMerged"));
+  stats.push_back(registerStatistic<uint64_t>("WriteBufForward"));
+  stats.push_back(registerStatistic<uint64_t>("WriteBufDrain"));
+  stats.push_back(registerStatistic<uint64_t>("PrefetchIssued"));
+  stats.push_back(registerStatistic<uint64_t>("PrefetchUseful"));
+  stats.push_back(registerStatistic<uint64_t>("PrefetchLate"));
+  stats.push_back(registerStatistic<uint64_t>("PrefetchDemand"));
+  stats.push_back(registerStatistic<uint64_t>("ReadOutstanding"));
+  stats.push_back(registerStatistic<uint64_t>("WriteOutstanding"));
+  stats.push_back(registerStatistic<uint64_t>("PrefetchOutstanding"));
+
+  for( unsigned c=0; c<_REV_LAT_CLASSES_; c++ ){
+    latStats[c][0] = registerStatistic<uint64_t>(std::string(LatClassNames[c]) + "QueueDelay");
+    latStats[c][1] = registerStatistic<uint64_t>(std::string(LatClassNames[c]) + "Latency");
+  }
+}
+
+void RevBasicMemCtrl::setNumCores(unsigned Cores){
+  RevMemCtrl::setNumCores(Cores);
+  coreLatStats.resize(Cores);
+  for( unsigned i=0; i<Cores; i++ ){
+    const std::string Core = "core" + std::to_string(i);
+    for( unsigned c=0; c<_REV_LAT_CLASSES_; c++ ){
+      coreLatStats[i].push_back(registerStatistic<uint64_t>(std::string(LatClassNames[c]) + "QueueDelay", Core));
+      coreLatStats[i].push_back(registerStatistic<uint64_t>(std::string(LatClassNames[c]) + "Latency", Core));
+    }
+  }
+}
+
+void RevBasicMemCtrl::recordLatency(RevMemOp *op){
+  const unsigned C = (unsigned)(op->getOp());
+  if( C >= _REV_LAT_CLASSES_ )
+    return ;
+  const uint64_t Queue = op->getIssueCycle() - op->getEnqueueCycle();
+  const uint64_t Latency = getCycle() - op->getIssueCycle();
+  latStats[C][0]->addData(Queue);
+  latStats[C][1]->addData(Latency);
+  if( op->getCore() < coreLatStats.size() ){
+    coreLatStats[op->getCore()][C*2]->addData(Queue);
+    coreLatStats[op->getCore()][C*2+1]->addData(Latency);
+  }
 }
 
 void RevBasicMemCtrl::recordStat(RevBasicMemCtrl::MemCtrlStats Stat,
                                  uint64_t Data){
-  if( Stat > RevBasicMemCtrl::MemCtrlStats::FencePending){
+  if( Stat > RevBasicMemCtrl::MemCtrlStats::PrefetchOutstanding){
     // do nothing
     return ;
   }
@@ -166,7 +283,7 @@ bool RevBasicMemCtrl::sendFLUSHRequest(uint64_t Addr,
     return true;
   RevMemOp *Op = new RevMemOp(Addr, PAddr, Size, RevMemOp::MemOp::MemOpFLUSH, flags);
   Op->setInv(Inv);
-  rqstQ.push_back(Op);
+  enqueueRqst(Op);
   recordStat(RevBasicMemCtrl::MemCtrlStats::FlushPending,1);
   return true;
 }
@@ -179,8 +296,10 @@ bool RevBasicMemCtrl::sendREADRequest(uint64_t Addr,
   if( Size == 0 )
     return true;
   RevMemOp *Op = new RevMemOp(Addr, PAddr, Size, target, RevMemOp::MemOp::MemOpREAD, flags);
-  rqstQ.push_back(Op);
+  enqueueRqst(Op);
   recordStat(RevBasicMemCtrl::MemCtrlStats::ReadPending,1);
+  if( prefetcher && !Op->isIFetch() )
+    observeRead(Addr, Size, flags);
   return true;
 }
 
@@ -192,7 +311,7 @@ bool RevBasicMemCtrl::sendWRITERequest(uint64_t Addr,
   if( Size == 0 )
     return true;
   RevMemOp *Op = new RevMemOp(Addr, PAddr, Size, buffer, RevMemOp::MemOp::MemOpWRITE, flags);
-  rqstQ.push_back(Op);
+  enqueueRqst(Op);
   recordStat(RevBasicMemCtrl::MemCtrlStats::WritePending,1);
   return true;
 }
@@ -205,7 +324,7 @@ bool RevBasicMemCtrl::sendREADLOCKRequest(uint64_t Addr,
   if( Size == 0 )
     return true;
   RevMemOp *Op = new RevMemOp(Addr, PAddr, Size, target, RevMemOp::MemOp::MemOpREADLOCK, flags);
-  rqstQ.push_back(Op);
+  enqueueRqst(Op);
   recordStat(RevBasicMemCtrl::MemCtrlStats::ReadLockPending,1);
   return true;
 }
@@ -218,11 +337,31 @@ bool RevBasicMemCtrl::sendWRITELOCKRequest(uint64_t Addr,
   if( Size == 0 )
     return true;
   RevMemOp *Op = new RevMemOp(Addr, PAddr, Size, buffer, RevMemOp::MemOp::MemOpWRITEUNLOCK, flags);
-  rqstQ.push_back(Op);
+  enqueueRqst(Op);
   recordStat(RevBasicMemCtrl::MemCtrlStats::WriteUnlockPending,1);
   return true;
 }
 
+bool RevBasicMemCtrl::sendAMORequest(uint64_t Addr,
+                                     uint64_t PAddr,
+                                     uint32_t Size,
+                                     char *buffer,
+                                     void *target,
+                                     StandardMem::Request::flags_t flags){
+  if( Size == 0 )
+    return true;
+  if( (Addr % Size) != 0 )
+    output->fatal(CALL_INFO, -1, "Error : misaligned AMO at address 0x%" PRIx64 "\n", Addr);
+
+  // the AMO is issued as a READLOCK; the response computes the new
+  // value and issues the matching WRITEUNLOCK for the same RevMemOp
+  RevMemOp *Op = new RevMemOp(Addr, PAddr, Size, buffer, target,
+                              RevMemOp::MemOp::MemOpREADLOCK, flags);
+  enqueueRqst(Op);
+  recordStat(RevBasicMemCtrl::MemCtrlStats::ReadLockPending,1);
+  return true;
+}
+
 bool RevBasicMemCtrl::sendLOADLINKRequest(uint64_t Addr,
                                           uint64_t PAddr,
                                           uint32_t Size,
@@ -230,7 +369,7 @@ bool RevBasicMemCtrl::sendLOADLINKRequest(uint64_t Addr,
   if( Size == 0 )
     return true;
   RevMemOp *Op = new RevMemOp(Addr, PAddr, Size, RevMemOp::MemOp::MemOpLOADLINK, flags);
-  rqstQ.push_back(Op);
+  enqueueRqst(Op);
   recordStat(RevBasicMemCtrl::MemCtrlStats::LoadLinkPending,1);
   return true;
 }
@@ -243,7 +382,7 @@ bool RevBasicMemCtrl::sendSTORECONDRequest(uint64_t Addr,
   if( Size == 0 )
     return true;
   RevMemOp *Op = new RevMemOp(Addr, PAddr, Size, buffer, RevMemOp::MemOp::MemOpSTORECOND, flags);
-  rqstQ.push_back(Op);
+  enqueueRqst(Op);
   recordStat(RevBasicMemCtrl::MemCtrlStats::StoreCondPending,1);
   return true;
 }
@@ -257,7 +396,7 @@ bool RevBasicMemCtrl::sendCUSTOMREADRequest(uint64_t Addr,
   if( Size == 0 )
     return true;
   RevMemOp *Op = new RevMemOp(Addr, PAddr, Size, target, Opc, RevMemOp::MemOp::MemOpCUSTOM, flags);
-  rqstQ.push_back(Op);
+  enqueueRqst(Op);
   recordStat(RevBasicMemCtrl::MemCtrlStats::CustomPending,1);
   return true;
 }
@@ -271,14 +410,14 @@ bool RevBasicMemCtrl::sendCUSTOMWRITERequest(uint64_t Addr,
   if( Size == 0 )
     return true;
   RevMemOp *Op = new RevMemOp(Addr, PAddr, Size, buffer, Opc, RevMemOp::MemOp::MemOpCUSTOM, flags);
-  rqstQ.push_back(Op);
+  enqueueRqst(Op);
   recordStat(RevBasicMemCtrl::MemCtrlStats::CustomPending,1);
   return true;
 }
 
 bool RevBasicMemCtrl::sendFENCE(){
   RevMemOp *Op = new RevMemOp(0x00ull, 0x00ull, 0x00, RevMemOp::MemOp::MemOpFENCE, 0x00);
-  rqstQ.push_back(Op);
+  enqueueRqst(Op);
   recordStat(RevBasicMemCtrl::MemCtrlStats::FencePending,1);
   return true;
 }
@@ -293,10 +432,18 @@ void RevBasicMemCtrl::processMemEvent(StandardMem::Request* ev){
 
 void RevBasicMemCtrl::init(unsigned int phase){
   memIface->init(phase);
+  if( instIface )
+    instIface->init(phase);
 
   // query the caching infrastructure
   if( phase == 1 ){
     lineSize = memIface->getLineSize();
+    if( instIface && (instIface->getLineSize() > 0) && (lineSize > 0) &&
+        (instIface->getLineSize() != lineSize) ){
+      output->fatal(CALL_INFO, -1,
+                    "Error : instruction fetch line size (%u) does not match the data line size (%u)\n",
+                    (unsigned)(instIface->getLineSize()), lineSize);
+    }
     if( lineSize > 0 ){
       output->verbose(CALL_INFO, 5, 0, "Detected cache layers; default line size=%d\n", lineSize);
       hasCache = true;
@@ -309,9 +456,20 @@ void RevBasicMemCtrl::init(unsigned int phase){
 
 void RevBasicMemCtrl::setup(){
   memIface->setup();
+  if( instIface )
+    instIface->setup();
 }
 
 void RevBasicMemCtrl::finish(){
+  if( prefetcher && (pfDemand > 0) ){
+    output->verbose(CALL_INFO, 1, 0,
+                    "Prefetch: issued=%" PRIu64 " useful=%" PRIu64 " late=%" PRIu64
+                    " accuracy=%.1f%% coverage=%.1f%% lateness=%.1f%%\n",
+                    pfIssued, pfUseful, pfLate,
+                    pfIssued ? (100.0 * (double)(pfUseful) / (double)(pfIssued)) : 0.0,
+                    100.0 * (double)(pfUseful) / (double)(pfDemand),
+                    pfUseful ? (100.0 * (double)(pfLate) / (double)(pfUseful)) : 0.0);
+  }
 }
 
 bool RevBasicMemCtrl::isMemOpAvail(RevMemOp *Op,
@@ -467,49 +625,49 @@ bool RevBasicMemCtrl::buildCacheMemRqst(RevMemOp *op,
   // if we don't have enough request slots, then requeue the entire RevMemOp
   switch(op->getOp()){
   case RevMemOp::MemOp::MemOpREAD:
-    if( (max_loads-num_read) < NumLines ){
+    if( (num_read + NumLines) > max_loads ){
       Success = false;
       return true;
     }
     break;
   case RevMemOp::MemOp::MemOpWRITE:
-    if( (max_stores-num_write) < NumLines ){
+    if( (num_write + NumLines) > max_stores ){
       Success = false;
       return true;
     }
     break;
   case RevMemOp::MemOp::MemOpFLUSH:
-    if( (max_flush-num_flush) < NumLines ){
+    if( (num_flush + NumLines) > max_flush ){
       Success = false;
       return true;
     }
     break;
   case RevMemOp::MemOp::MemOpREADLOCK:
-    if( (max_readlock-num_readlock) < NumLines ){
+    if( (num_readlock + NumLines) > max_readlock ){
       Success = false;
       return true;
     }
     break;
   case RevMemOp::MemOp::MemOpWRITEUNLOCK:
-    if( (max_writeunlock-num_writeunlock) < NumLines ){
+    if( (num_writeunlock + NumLines) > max_writeunlock ){
       Success = false;
       return true;
     }
     break;
   case RevMemOp::MemOp::MemOpLOADLINK:
-    if( (max_llsc-num_llsc) < NumLines ){
+    if( (num_llsc + NumLines) > max_llsc ){
       Success = false;
       return true;
     }
     break;
   case RevMemOp::MemOp::MemOpSTORECOND:
-    if( (max_llsc-num_llsc) < NumLines ){
+    if( (num_llsc + NumLines) > max_llsc ){
       Success = false;
       return true;
     }
     break;
   case RevMemOp::MemOp::MemOpCUSTOM:
-    if( (max_custom-num_custom) < NumLines ){
+    if( (num_custom + NumLines) > max_custom ){
       Success = false;
       return true;
     }
@@ -531,7 +689,7 @@ bool RevBasicMemCtrl::buildCacheMemRqst(RevMemOp *op,
 
   op->setSplitRqst(NumLines);
 
-  std::vector<uint8_t> tmpBuf = op->getBuf();
+  const uint8_t *tmpBuf = op->getBuf();
   std::vector<uint8_t> newBuf;
   unsigned BaseCacheLineSize = 0;
   if( NumLines > 1 ){
@@ -554,9 +712,8 @@ bool RevBasicMemCtrl::buildCacheMemRqst(RevMemOp *op,
     rqst = new Interfaces::StandardMem::Read(op->getAddr(),
                                              (uint64_t)(BaseCacheLineSize),
                                              TmpFlags);
-    requests.push_back(rqst->getID());
-    outstanding[rqst->getID()] = op;
-    memIface->send(rqst);
+    trackRqst(rqst, op);
+    getIface(op)->send(rqst);
     recordStat(ReadInFlight,1);
     num_read++;
     break;
@@ -564,17 +721,14 @@ bool RevBasicMemCtrl::buildCacheMemRqst(RevMemOp *op,
 #ifdef _REV_DEBUG_
     std::cout << "<<<< WRITE REQUEST >>>>" << std::endl;
 #endif
-    for( unsigned i=0; i<BaseCacheLineSize; i++ ){
-      newBuf.push_back(tmpBuf[i]);
-    }
+    newBuf.assign(tmpBuf, tmpBuf + BaseCacheLineSize);
     curByte = BaseCacheLineSize;
     rqst = new Interfaces::StandardMem::Write(op->getAddr(),
                                               (uint64_t)(BaseCacheLineSize),
                                               newBuf,
                                               TmpFlags);
-    requests.push_back(rqst->getID());
-    outstanding[rqst->getID()] = op;
-    memIface->send(rqst);
+    trackRqst(rqst, op);
+    getIface(op)->send(rqst);
     recordStat(WriteInFlight,1);
     num_write++;
     break;
@@ -584,9 +738,8 @@ bool RevBasicMemCtrl::buildCacheMemRqst(RevMemOp *op,
                                                   op->getInv(),
                                                   (uint64_t)(BaseCacheLineSize),
                                                   TmpFlags);
-    requests.push_back(rqst->getID());
-    outstanding[rqst->getID()] = op;
-    memIface->send(rqst);
+    trackRqst(rqst, op);
+    getIface(op)->send(rqst);
     recordStat(FlushInFlight,1);
     num_flush++;
     break;
@@ -594,25 +747,21 @@ bool RevBasicMemCtrl::buildCacheMemRqst(RevMemOp *op,
     rqst = new Interfaces::StandardMem::ReadLock(op->getAddr(),
                                                  (uint64_t)(BaseCacheLineSize),
                                                  TmpFlags);
-    requests.push_back(rqst->getID());
-    outstanding[rqst->getID()] = op;
-    memIface->send(rqst);
+    trackRqst(rqst, op);
+    getIface(op)->send(rqst);
     recordStat(ReadLockInFlight,1);
     num_readlock++;
     break;
   case RevMemOp::MemOp::MemOpWRITEUNLOCK:
-    for( unsigned i=0; i<BaseCacheLineSize; i++ ){
-      newBuf.push_back(tmpBuf[i]);
-    }
+    newBuf.assign(tmpBuf, tmpBuf + BaseCacheLineSize);
     curByte = BaseCacheLineSize;
     rqst = new Interfaces::StandardMem::WriteUnlock(op->getAddr(),
                                                     (uint64_t)(BaseCacheLineSize),
                                                     newBuf,
                                                     false,
                                                     TmpFlags);
-    requests.push_back(rqst->getID());
-    outstanding[rqst->getID()] = op;
-    memIface->send(rqst);
+    trackRqst(rqst, op);
+    getIface(op)->send(rqst);
     recordStat(WriteUnlockInFlight,1);
     num_writeunlock++;
     break;
@@ -620,33 +769,28 @@ bool RevBasicMemCtrl::buildCacheMemRqst(RevMemOp *op,
     rqst = new Interfaces::StandardMem::LoadLink(op->getAddr(),
                                                  (uint64_t)(BaseCacheLineSize),
                                                  TmpFlags);
-    requests.push_back(rqst->getID());
-    outstanding[rqst->getID()] = op;
-    memIface->send(rqst);
+    trackRqst(rqst, op);
+    getIface(op)->send(rqst);
     recordStat(LoadLinkInFlight,1);
     num_llsc++;
     break;
   case RevMemOp::MemOp::MemOpSTORECOND:
-    for( unsigned i=0; i<BaseCacheLineSize; i++ ){
-      newBuf.push_back(tmpBuf[i]);
-    }
+    newBuf.assign(tmpBuf, tmpBuf + BaseCacheLineSize);
     curByte = BaseCacheLineSize;
     rqst = new Interfaces::StandardMem::StoreConditional(op->getAddr(),
                                                          (uint64_t)(BaseCacheLineSize),
                                                          newBuf,
                                                          TmpFlags);
-    requests.push_back(rqst->getID());
-    outstanding[rqst->getID()] = op;
-    memIface->send(rqst);
+    trackRqst(rqst, op);
+    getIface(op)->send(rqst);
     recordStat(StoreCondInFlight,1);
     num_llsc++;
     break;
   case RevMemOp::MemOp::MemOpCUSTOM:
     // TODO: need more support for custom memory ops
     rqst = new Interfaces::StandardMem::CustomReq(nullptr, TmpFlags);
-    requests.push_back(rqst->getID());
-    outstanding[rqst->getID()] = op;
-    memIface->send(rqst);
+    trackRqst(rqst, op);
+    getIface(op)->send(rqst);
     recordStat(CustomInFlight,1);
     num_custom++;
     break;
@@ -680,24 +824,20 @@ bool RevBasicMemCtrl::buildCacheMemRqst(RevMemOp *op,
       rqst = new Interfaces::StandardMem::Read(newBase,
                                                newSize,
                                                TmpFlags);
-      requests.push_back(rqst->getID());
-      outstanding[rqst->getID()] = op;
-      memIface->send(rqst);
+      trackRqst(rqst, op);
+      getIface(op)->send(rqst);
       recordStat(ReadInFlight,1);
       num_read++;
       break;
     case RevMemOp::MemOp::MemOpWRITE:
-      for( unsigned j=curByte; j<(curByte+newSize); j++ ){
-        newBuf.push_back(tmpBuf[j]);
-      }
+      newBuf.assign(tmpBuf + curByte, tmpBuf + curByte + newSize);
       curByte += newSize;
       rqst = new Interfaces::StandardMem::Write(newBase,
                                                 newSize,
                                                 newBuf,
                                                 TmpFlags);
-      requests.push_back(rqst->getID());
-      outstanding[rqst->getID()] = op;
-      memIface->send(rqst);
+      trackRqst(rqst, op);
+      getIface(op)->send(rqst);
       recordStat(WriteInFlight,1);
       num_write++;
       break;
@@ -707,9 +847,8 @@ bool RevBasicMemCtrl::buildCacheMemRqst(RevMemOp *op,
                                                     op->getInv(),
                                                     newSize,
                                                     TmpFlags);
-      requests.push_back(rqst->getID());
-      outstanding[rqst->getID()] = op;
-      memIface->send(rqst);
+      trackRqst(rqst, op);
+      getIface(op)->send(rqst);
       recordStat(FlushInFlight,1);
       num_flush++;
       break;
@@ -717,25 +856,21 @@ bool RevBasicMemCtrl::buildCacheMemRqst(RevMemOp *op,
       rqst = new Interfaces::StandardMem::ReadLock(newBase,
                                                    newSize,
                                                    TmpFlags);
-      requests.push_back(rqst->getID());
-      outstanding[rqst->getID()] = op;
-      memIface->send(rqst);
+      trackRqst(rqst, op);
+      getIface(op)->send(rqst);
       recordStat(ReadLockInFlight,1);
       num_readlock++;
       break;
     case RevMemOp::MemOp::MemOpWRITEUNLOCK:
-      for( unsigned j=curByte; j<(curByte+newSize); j++ ){
-        newBuf.push_back(tmpBuf[j]);
-      }
+      newBuf.assign(tmpBuf + curByte, tmpBuf + curByte + newSize);
       curByte += newSize;
       rqst = new Interfaces::StandardMem::WriteUnlock(newBase,
                                                       newSize,
                                                       newBuf,
                                                       false,
                                                       TmpFlags);
-      requests.push_back(rqst->getID());
-      outstanding[rqst->getID()] = op;
-      memIface->send(rqst);
+      trackRqst(rqst, op);
+      getIface(op)->send(rqst);
       recordStat(WriteUnlockInFlight,1);
       num_writeunlock++;
       break;
@@ -743,33 +878,28 @@ bool RevBasicMemCtrl::buildCacheMemRqst(RevMemOp *op,
       rqst = new Interfaces::StandardMem::LoadLink(newBase,
                                                    newSize,
                                                    TmpFlags);
-      requests.push_back(rqst->getID());
-      outstanding[rqst->getID()] = op;
-      memIface->send(rqst);
+      trackRqst(rqst, op);
+      getIface(op)->send(rqst);
       recordStat(LoadLinkInFlight,1);
       num_llsc++;
       break;
     case RevMemOp::MemOp::MemOpSTORECOND:
-      for( unsigned j=curByte; j<(curByte+newSize); j++ ){
-        newBuf.push_back(tmpBuf[j]);
-      }
+      newBuf.assign(tmpBuf + curByte, tmpBuf + curByte + newSize);
       curByte += newSize;
       rqst = new Interfaces::StandardMem::StoreConditional(newBase,
                                                            newSize,
                                                            newBuf,
                                                            TmpFlags);
-      requests.push_back(rqst->getID());
-      outstanding[rqst->getID()] = op;
-      memIface->send(rqst);
+      trackRqst(rqst, op);
+      getIface(op)->send(rqst);
       recordStat(StoreCondInFlight,1);
       num_llsc++;
       break;
     case RevMemOp::MemOp::MemOpCUSTOM:
       // TODO: need more support for custom memory ops
       rqst = new Interfaces::StandardMem::CustomReq(nullptr, TmpFlags);
-      requests.push_back(rqst->getID());
-      outstanding[rqst->getID()] = op;
-      memIface->send(rqst);
+      trackRqst(rqst, op);
+      getIface(op)->send(rqst);
       recordStat(CustomInFlight,1);
       num_custom++;
       break;
@@ -801,20 +931,18 @@ bool RevBasicMemCtrl::buildRawMemRqst(RevMemOp *op,
     rqst = new Interfaces::StandardMem::Read(op->getAddr(),
                                              (uint64_t)(op->getSize()),
                                              TmpFlags);
-    requests.push_back(rqst->getID());
-    outstanding[rqst->getID()] = op;
-    memIface->send(rqst);
+    trackRqst(rqst, op);
+    getIface(op)->send(rqst);
     recordStat(ReadInFlight,1);
     num_read++;
     break;
   case RevMemOp::MemOp::MemOpWRITE:
     rqst = new Interfaces::StandardMem::Write(op->getAddr(),
                                               (uint64_t)(op->getSize()),
-                                              op->getBuf(),
+                                              op->getBufVector(),
                                               TmpFlags);
-    requests.push_back(rqst->getID());
-    outstanding[rqst->getID()] = op;
-    memIface->send(rqst);
+    trackRqst(rqst, op);
+    getIface(op)->send(rqst);
     recordStat(WriteInFlight,1);
     num_write++;
     break;
@@ -824,9 +952,8 @@ bool RevBasicMemCtrl::buildRawMemRqst(RevMemOp *op,
                                                   op->getInv(),
                                                   (uint64_t)(op->getSize()),
                                                   TmpFlags);
-    requests.push_back(rqst->getID());
-    outstanding[rqst->getID()] = op;
-    memIface->send(rqst);
+    trackRqst(rqst, op);
+    getIface(op)->send(rqst);
     recordStat(FlushInFlight,1);
     num_flush++;
     break;
@@ -834,21 +961,19 @@ bool RevBasicMemCtrl::buildRawMemRqst(RevMemOp *op,
     rqst = new Interfaces::StandardMem::ReadLock(op->getAddr(),
                                                  (uint64_t)(op->getSize()),
                                                  TmpFlags);
-    requests.push_back(rqst->getID());
-    outstanding[rqst->getID()] = op;
-    memIface->send(rqst);
+    trackRqst(rqst, op);
+    getIface(op)->send(rqst);
     recordStat(ReadLockInFlight,1);
     num_readlock++;
     break;
   case RevMemOp::MemOp::MemOpWRITEUNLOCK:
     rqst = new Interfaces::StandardMem::WriteUnlock(op->getAddr(),
                                                     (uint64_t)(op->getSize()),
-                                                    op->getBuf(),
+                                                    op->getBufVector(),
                                                     false,
                                                     TmpFlags);
-    requests.push_back(rqst->getID());
-    outstanding[rqst->getID()] = op;
-    memIface->send(rqst);
+    trackRqst(rqst, op);
+    getIface(op)->send(rqst);
     recordStat(WriteUnlockInFlight,1);
     num_writeunlock++;
     break;
@@ -856,29 +981,26 @@ bool RevBasicMemCtrl::buildRawMemRqst(RevMemOp *op,
     rqst = new Interfaces::StandardMem::LoadLink(op->getAddr(),
                                                  (uint64_t)(op->getSize()),
                                                  TmpFlags);
-    requests.push_back(rqst->getID());
-    outstanding[rqst->getID()] = op;
-    memIface->send(rqst);
+    trackRqst(rqst, op);
+    getIface(op)->send(rqst);
     recordStat(LoadLinkInFlight,1);
     num_llsc++;
     break;
   case RevMemOp::MemOp::MemOpSTORECOND:
     rqst = new Interfaces::StandardMem::StoreConditional(op->getAddr(),
                                                         (uint64_t)(op->getSize()),
-                                                        op->getBuf(),
+                                                        op->getBufVector(),
                                                         TmpFlags);
-    requests.push_back(rqst->getID());
-    outstanding[rqst->getID()] = op;
-    memIface->send(rqst);
+    trackRqst(rqst, op);
+    getIface(op)->send(rqst);
     recordStat(StoreCondInFlight,1);
     num_llsc++;
     break;
   case RevMemOp::MemOp::MemOpCUSTOM:
     // TODO: need more support for custom memory ops
     rqst = new Interfaces::StandardMem::CustomReq(nullptr, TmpFlags);
-    requests.push_back(rqst->getID());
-    outstanding[rqst->getID()] = op;
-    memIface->send(rqst);
+    trackRqst(rqst, op);
+    getIface(op)->send(rqst);
     recordStat(CustomInFlight,1);
     num_custom++;
     break;
@@ -893,7 +1015,9 @@ bool RevBasicMemCtrl::buildRawMemRqst(RevMemOp *op,
 }
 
 bool RevBasicMemCtrl::buildStandardMemRqst(RevMemOp *op,
-                                           bool &Success){
+                                           bool &Success,
+                                           unsigned &t_max_stores,
+                                           unsigned &t_max_ops){
   if( !op ){
     return false;
   }
@@ -927,6 +1051,35 @@ bool RevBasicMemCtrl::buildStandardMemRqst(RevMemOp *op,
   // RevMemOp
   // ---------------------------------------------------------
   StandardMem::Request::flags_t TmpFlags;
+  if( coalesceLoads && (op->getOp() != RevMemOp::MemOp::MemOpREAD) ){
+    closeMSHRs(op);
+  }
+
+  if( wbufEntries > 0 ){
+    // posted writes are older than this op; keep it ordered behind them
+    if( op->getOp() == RevMemOp::MemOp::MemOpREAD ){
+      if( forwardRead(op, t_max_stores, t_max_ops, Success) )
+        return true;
+    }else if( op->getOp() == RevMemOp::MemOp::MemOpWRITE ){
+      if( postWrite(op, t_max_stores, t_max_ops, Success) )
+        return true;
+    }else if( !drainWBufLines(op, t_max_stores, t_max_ops) ){
+      Success = false;
+      return true;
+    }
+
+    // the drains above may have used the slot this op claimed
+    if( !wbufFits(t_max_stores, t_max_ops) ){
+      Success = false;
+      return true;
+    }
+  }
+
+  if( coalesceLoads && (op->getOp() == RevMemOp::MemOp::MemOpREAD) ){
+    if( coalesceRead(op, Success) )
+      return true;
+  }
+
   if( (hasCache) &&
       (op->isCacheable()) ){
     // cache is enabled and we want to cache the request
@@ -944,6 +1097,385 @@ bool RevBasicMemCtrl::buildStandardMemRqst(RevMemOp *op,
   }
 }
 
+bool RevBasicMemCtrl::coalesceRead(RevMemOp *op, bool &Success){
+  // only cacheable reads that stay within a single line are eligible;
+  // fills are tracked per interface, so fetches on instIface never merge
+  if( !hasCache || !op->isCacheable() || (getNumCacheLines(op->getAddr(), op->getSize()) != 1) ||
+      (getIface(op) != memIface) )
+    return false;
+
+  // a merged read is still an outstanding load, so it holds a load slot
+  // until its fill returns
+  if( (num_read + 1) > max_loads ){
+    Success = false;
+    return true;
+  }
+
+  const uint64_t Line = op->getAddr() - (op->getAddr() % lineSize);
+  auto it = mshrOpen.find(Line);
+  if( it != mshrOpen.end() ){
+    // the line is already being filled; wait on that fill
+    mshrWaiters[it->second].push_back(op);
+    recordStat(ReadCoalesced,1);
+    num_read++;
+    Success = true;
+    return true;
+  }
+
+  // fetch the whole line so that later reads to it can be merged
+  StandardMem::Request *rqst = new Interfaces::StandardMem::Read(Line,
+                                                                 (uint64_t)(lineSize),
+                                                                 op->getStdFlags());
+  mshrOpen.emplace(Line, rqst->getID());
+  mshrWaiters[rqst->getID()].push_back(op);
+  trackRqst(rqst, op);
+  memIface->send(rqst);
+  recordStat(ReadInFlight,1);
+  recordStat(MSHRLines,(uint64_t)(mshrWaiters.size()));
+  num_read++;
+  Success = true;
+  return true;
+}
+
+void RevBasicMemCtrl::closeMSHRs(RevMemOp *op){
+  // reads queued behind a write, atomic or flush must observe it, so
+  // they may no longer be satisfied by a fill issued before it
+  if( mshrOpen.empty() )
+    return ;
+  if( op->getOp() == RevMemOp::MemOp::MemOpCUSTOM ){
+    mshrOpen.clear();
+    return ;
+  }
+  const uint64_t First = op->getAddr() - (op->getAddr() % lineSize);
+  const uint64_t Last = (op->getAddr() + (op->getSize() ? op->getSize() - 1 : 0));
+  for( uint64_t Line = First; Line <= Last; Line += lineSize ){
+    mshrOpen.erase(Line);
+  }
+}
+
+void RevBasicMemCtrl::handleMSHRResp(StandardMem::ReadResp* ev,
+                                     std::vector<RevMemOp *> &Waiters){
+  const uint64_t Line = (uint64_t)(ev->pAddr);
+  auto it = mshrOpen.find(Line);
+  if( (it != mshrOpen.end()) && (it->second == ev->getID()) )
+    mshrOpen.erase(it);
+
+  // the first waiter is the op that issued the fill
+  for( RevMemOp *W : Waiters ){
+    const uint64_t Offset = W->getAddr() - Line;
+    std::memcpy(W->getTarget(), &ev->data[Offset], W->getSize());
+    handleFlagResp(W);
+    retireRqst(RevMemOp::MemOp::MemOpREAD);
+    recordLatency(W);
+    delete W;
+  }
+  Waiters.clear();
+  delete ev;
+}
+
+bool RevBasicMemCtrl::forceDrainWBufEntry(RevMemOp *op,
+                                          std::deque<RevWBufEntry>::iterator it,
+                                          unsigned &t_max_stores,
+                                          unsigned &t_max_ops){
+  // a forced drain may borrow the slots the triggering op already
+  // claimed this cycle; the op then waits for the next cycle.  each
+  // write sent takes a store slot, an op slot and an outstanding store
+  const unsigned Own = (op->getOp() == RevMemOp::MemOp::MemOpWRITE) ? 1 : 0;
+  unsigned Budget = 0;
+  if( (t_max_ops <= max_ops) &&
+      (t_max_stores < (max_stores + Own)) &&
+      (num_write < max_stores) ){
+    Budget = std::min({max_stores + Own - t_max_stores,
+                       max_ops + 1 - t_max_ops,
+                       (unsigned)(max_stores - num_write)});
+  }
+  const unsigned Avail = Budget;
+  const bool Released = drainWBufEntry(it, Budget);
+  t_max_stores += Avail - Budget;
+  t_max_ops += Avail - Budget;
+  return Released;
+}
+
+bool RevBasicMemCtrl::postWrite(RevMemOp *op,
+                                unsigned &t_max_stores,
+                                unsigned &t_max_ops,
+                                bool &Success){
+  if( !isWBufEligible(op) ){
+    if( drainWBufLines(op, t_max_stores, t_max_ops) )
+      return false;
+    Success = false;
+    return true;
+  }
+
+  const uint64_t Line = op->getAddr() - (op->getAddr() % lineSize);
+  auto it = std::find_if(wbuf.begin(), wbuf.end(),
+                         [Line](const RevWBufEntry &E){ return E.Line == Line; });
+  if( (it != wbuf.end()) && (it->Flags != op->getFlags()) ){
+    // stores with different flags are never gathered into one request
+    if( !forceDrainWBufEntry(op, it, t_max_stores, t_max_ops) ){
+      Success = false;
+      return true;
+    }
+    it = wbuf.end();
+  }
+
+  if( (it == wbuf.end()) && (wbuf.size() >= wbufEntries) ){
+    if( !forceDrainWBufEntry(op, wbuf.begin(), t_max_stores, t_max_ops) ){
+      Success = false;
+      return true;
+    }
+  }
+
+  if( !wbufFits(t_max_stores, t_max_ops) ){
+    Success = false;
+    return true;
+  }
+
+  if( it == wbuf.end() ){
+    RevWBufEntry E;
+    E.Line = Line;
+    E.PLine = op->getPhysAddr() - (op->getAddr() - Line);
+    E.Cycle = curCycle;
+    E.NumValid = 0;
+    E.Flags = op->getFlags();
+    E.Core = op->getCore();
+    E.Data.resize(lineSize);
+    E.Valid.resize(lineSize);
+    wbuf.push_back(std::move(E));
+    it = wbuf.end() - 1;
+  }else{
+    recordStat(WriteBufMerged,1);
+  }
+
+  const unsigned Offset = (unsigned)(op->getAddr() - Line);
+  std::memcpy(&it->Data[Offset], op->getBuf(), op->getSize());
+  for( unsigned i=Offset; i<Offset+op->getSize(); i++ ){
+    if( !it->Valid[i] ){
+      it->Valid[i] = 1;
+      it->NumValid++;
+    }
+  }
+  recordLatency(op);
+  delete op;
+  Success = true;
+  return true;
+}
+
+bool RevBasicMemCtrl::forwardRead(RevMemOp *op,
+                                  unsigned &t_max_stores,
+                                  unsigned &t_max_ops,
+                                  bool &Success){
+  if( wbuf.empty() )
+    return false;
+  if( !isWBufEligible(op) ){
+    if( drainWBufLines(op, t_max_stores, t_max_ops) )
+      return false;
+    Success = false;
+    return true;
+  }
+
+  const uint64_t Line = op->getAddr() - (op->getAddr() % lineSize);
+  auto it = std::find_if(wbuf.begin(), wbuf.end(),
+                         [Line](const RevWBufEntry &E){ return E.Line == Line; });
+  if( it == wbuf.end() )
+    return false;
+
+  const unsigned Offset = (unsigned)(op->getAddr() - Line);
+  for( unsigned i=Offset; i<Offset+op->getSize(); i++ ){
+    if( !it->Valid[i] ){
+      // only part of the read is buffered; write the line back and read it from memory
+      if( !forceDrainWBufEntry(op, it, t_max_stores, t_max_ops) ){
+        Success = false;
+        return true;
+      }
+      return false;
+    }
+  }
+
+  std::memcpy(op->getTarget(), &it->Data[Offset], op->getSize());
+  handleFlagResp(op);
+  recordStat(WriteBufForward,1);
+  recordLatency(op);
+  delete op;
+  Success = true;
+  return true;
+}
+
+bool RevBasicMemCtrl::drainWBufLines(RevMemOp *op,
+                                     unsigned &t_max_stores,
+                                     unsigned &t_max_ops){
+  if( wbuf.empty() )
+    return true;
+  if( op->getOp() == RevMemOp::MemOp::MemOpCUSTOM ){
+    while( !wbuf.empty() ){
+      if( !forceDrainWBufEntry(op, wbuf.begin(), t_max_stores, t_max_ops) )
+        return false;
+    }
+    return true;
+  }
+  const uint64_t First = op->getAddr() - (op->getAddr() % lineSize);
+  const uint64_t Last = (op->getAddr() + (op->getSize() ? op->getSize() - 1 : 0));
+  auto it = wbuf.begin();
+  while( it != wbuf.end() ){
+    if( (it->Line >= First) && (it->Line <= Last) ){
+      if( !forceDrainWBufEntry(op, it, t_max_stores, t_max_ops) )
+        return false;
+      it = wbuf.begin();
+    }else{
+      it++;
+    }
+  }
+  return true;
+}
+
+bool RevBasicMemCtrl::drainWBufEntry(std::deque<RevWBufEntry>::iterator it,
+                                     unsigned &Budget){
+  // issue one write per contiguous run of written bytes; the runs
+  // that do not fit in the budget stay buffered
+  unsigned i = 0;
+  while( i < lineSize ){
+    if( !it->Valid[i] ){
+      i++;
+      continue;
+    }
+    if( Budget == 0 )
+      return false;
+    unsigned j = i;
+    while( (j < lineSize) && it->Valid[j] )
+      j++;
+    RevMemOp *W = new RevMemOp(it->Line + i, it->PLine + i, j - i,
+                               (char *)(&it->Data[i]),
+                               RevMemOp::MemOp::MemOpWRITE, it->Flags);
+    W->setCore(it->Core);
+    W->setEnqueueCycle(it->Cycle);
+    W->setIssueCycle(curCycle);
+    StandardMem::Request *rqst = new Interfaces::StandardMem::Write(W->getAddr(),
+                                                                    (uint64_t)(W->getSize()),
+                                                                    W->getBufVector(),
+                                                                    W->getStdFlags());
+    trackRqst(rqst, W);
+    memIface->send(rqst);
+    recordStat(WriteInFlight,1);
+    num_write++;
+    Budget--;
+    for( unsigned k=i; k<j; k++ )
+      it->Valid[k] = 0;
+    it->NumValid -= (j - i);
+    i = j;
+  }
+  recordStat(WriteBufDrain,1);
+  wbuf.erase(it);
+  return true;
+}
+
+void RevBasicMemCtrl::drainWBuf(unsigned &t_max_stores, bool Force){
+  while( !wbuf.empty() && (t_max_stores < max_stores) && (num_write < max_stores) ){
+    const RevWBufEntry &E = wbuf.front();
+    if( !Force &&
+        (E.NumValid < lineSize) &&
+        (wbuf.size() <= wbufEntries/2) &&
+        ((curCycle - E.Cycle) < wbufDrainAge) ){
+      return ;
+    }
+    unsigned Budget = std::min(max_stores - t_max_stores, (unsigned)(max_stores - num_write));
+    const unsigned Avail = Budget;
+    const bool Released = drainWBufEntry(wbuf.begin(), Budget);
+    t_max_stores += Avail - Budget;
+    if( !Released )
+      return ;
+  }
+}
+
+void RevBasicMemCtrl::observeRead(uint64_t Addr, uint32_t Size,
+                                  StandardMem::Request::flags_t flags){
+  if( !hasCache || ((uint32_t)(flags) & (uint32_t)(RevCPU::RevFlag::F_NONCACHEABLE)) )
+    return ;
+
+  pfDemand++;
+  recordStat(PrefetchDemand,1);
+  const uint64_t Line = Addr - (Addr % lineSize);
+  auto it = pfLines.find(Line);
+  if( it != pfLines.end() ){
+    pfUseful++;
+    recordStat(PrefetchUseful,1);
+    if( !it->second.second ){
+      pfLate++;
+      recordStat(PrefetchLate,1);
+    }
+    pfLines.erase(it);
+  }
+
+  pfCandidates.clear();
+  prefetcher->observe(Addr, activePC, lineSize, pfCandidates);
+  for( uint64_t C : pfCandidates ){
+    if( (C == Line) || (pfLines.find(C) != pfLines.end()) ||
+        (std::find(pfQueue.begin(), pfQueue.end(), C) != pfQueue.end()) )
+      continue;
+    if( pfQueue.size() >= pfQueueSize )
+      pfQueue.pop_front();
+    pfQueue.push_back(C);
+  }
+}
+
+void RevBasicMemCtrl::issuePrefetches(unsigned &t_max_loads,
+                                      unsigned &t_idle_ops){
+  // prefetches only use the read and issue slots that demand requests left
+  // idle, and in flight they never hold more than the free outstanding loads
+  while( !pfQueue.empty() && (t_max_loads < max_loads) && (t_idle_ops > 0) &&
+         ((num_read + pfRqsts.size()) < max_loads) ){
+    const uint64_t Line = pfQueue.front();
+    pfQueue.pop_front();
+    if( (pfLines.find(Line) != pfLines.end()) || (mshrOpen.find(Line) != mshrOpen.end()) )
+      continue;
+
+    // forget the oldest prefetched lines that were never used
+    while( pfOrder.size() >= _REV_PF_TRACK_ ){
+      auto L = pfLines.find(pfOrder.front().first);
+      if( (L != pfLines.end()) && (L->second.first == pfOrder.front().second) )
+        pfLines.erase(L);
+      pfOrder.pop_front();
+    }
+
+    StandardMem::Request *rqst = new Interfaces::StandardMem::Read(Line,
+                                                                   (uint64_t)(lineSize),
+                                                                   0);
+    pfRqsts.emplace(rqst->getID(), Line);
+    pfLines.emplace(Line, std::make_pair(pfIssued, false));
+    pfOrder.push_back(std::make_pair(Line, pfIssued));
+    memIface->send(rqst);
+    pfIssued++;
+    recordStat(PrefetchIssued,1);
+    t_max_loads++;
+    t_idle_ops--;
+  }
+}
+
+RevBasicMemCtrl::RqstClass RevBasicMemCtrl::getRqstClass(RevMemOp *op){
+  switch(op->getOp()){
+  case RevMemOp::MemOp::MemOpREAD:
+    return op->isIFetch() ? RqstIFETCH : RqstREAD;
+  case RevMemOp::MemOp::MemOpWRITE:
+    return RqstWRITE;
+  case RevMemOp::MemOp::MemOpFLUSH:
+    return RqstFLUSH;
+  case RevMemOp::MemOp::MemOpLOADLINK:
+  case RevMemOp::MemOp::MemOpSTORECOND:
+    return RqstLLSC;
+  case RevMemOp::MemOp::MemOpREADLOCK:
+    return RqstREADLOCK;
+  case RevMemOp::MemOp::MemOpWRITEUNLOCK:
+    return RqstWRITEUNLOCK;
+  case RevMemOp::MemOp::MemOpCUSTOM:
+    return RqstCUSTOM;
+  case RevMemOp::MemOp::MemOpFENCE:
+    return RqstFENCE;
+  default:
+    output->fatal(CALL_INFO, -1, "Error : unknown memory operation type\n");
+    break;
+  }
+  return RqstFENCE;
+}
+
 bool RevBasicMemCtrl::processNextRqst(unsigned &t_max_loads,
                                       unsigned &t_max_stores,
                                       unsigned &t_max_flush,
@@ -951,18 +1483,48 @@ bool RevBasicMemCtrl::processNextRqst(unsigned &t_max_loads,
                                       unsigned &t_max_readlock,
                                       unsigned &t_max_writeunlock,
                                       unsigned &t_max_custom,
-                                      unsigned &t_max_ops){
-  if( rqstQ.size() == 0 ){
+                                      unsigned &t_max_ops,
+                                      unsigned &t_idle_ops){
+  if( numQueued == 0 ){
     // nothing to do, saturate and exit this cycle
+    t_idle_ops = max_ops - t_max_ops;
     t_max_ops = max_ops;
     return true;
   }
 
   bool success = false;
 
+  // offer the head of each class queue in arrival order.  the issue
+  // limits are per class, so this selects the same op as a scan of a
+  // single queue would.  a FENCE is always available, so nothing queued
+  // behind it can be issued ahead of it.
+  unsigned Heads[RqstNumClasses];
+  unsigned NumHeads = 0;
+  for( unsigned c=0; c<RqstNumClasses; c++ ){
+    if( !rqstQ[c].empty() )
+      Heads[NumHeads++] = c;
+  }
+  std::sort(Heads, Heads+NumHeads, [this](unsigned A, unsigned B){
+    return rqstQ[A].front().first < rqstQ[B].front().first;
+  });
+
+  // a stalled front end has nothing to issue until its fetch returns,
+  // so offer the oldest fetch first.  fetches never pass a FENCE.
+  if( numFetchStalled > 0 ){
+    for( unsigned i=0; i<NumHeads; i++ ){
+      if( Heads[i] == RqstFENCE )
+        break;
+      if( Heads[i] == RqstIFETCH ){
+        std::rotate(Heads, Heads+i, Heads+i+1);
+        break;
+      }
+    }
+  }
+
   // retrieve the next candidate memory operation
-  for( unsigned i=0; i<rqstQ.size(); i++ ){
-    RevMemOp *op = rqstQ[i];
+  for( unsigned i=0; i<NumHeads; i++ ){
+    std::deque<std::pair<uint64_t,RevMemOp *>> &Q = rqstQ[Heads[i]];
+    RevMemOp *op = Q.front().second;
     if( isMemOpAvail(op,
                      t_max_loads,
                      t_max_stores,
@@ -979,21 +1541,24 @@ bool RevBasicMemCtrl::processNextRqst(unsigned &t_max_loads,
         // saturate and exit this cycle
         // no need to build a StandardMem request
         t_max_ops = max_ops;
-        rqstQ.erase(rqstQ.begin()+i);
+        Q.pop_front();
+        numQueued--;
         num_fence+=1;
         delete op;
         return true;
       }
 
       // build a StandardMem request
-      if( !buildStandardMemRqst(op, success) ){
+      op->setIssueCycle(curCycle);
+      if( !buildStandardMemRqst(op, success, t_max_stores, t_max_ops) ){
         output->fatal(CALL_INFO, -1, "Error : failed to build memory request");
         return false;
       }
 
       // sent the request, remove it
       if( success ){
-        rqstQ.erase(rqstQ.begin()+i);
+        Q.pop_front();
+        numQueued--;
       }else{
         // go ahead and max out our current request window
         // otherwise, this request for induce an infinite loop
@@ -1008,14 +1573,18 @@ bool RevBasicMemCtrl::processNextRqst(unsigned &t_max_loads,
   // if we reach this point, then we've attempted to
   // process all the potential requests.  none exist
   // that can be dispatched at this time.
+  t_idle_ops = max_ops - t_max_ops;
   t_max_ops = max_ops;
 
 #ifdef _REV_DEBUG_
-  for( unsigned i=0; i<rqstQ.size(); i++ ){
-    std::cout << "rqstQ[" << i << "] = " << rqstQ[i]->getOp() << " @ 0x"
-              << std::hex << rqstQ[i]->getAddr() << std::dec
-              << "; physAddr = 0x" << std::hex << rqstQ[i]->getPhysAddr()
-              << std::dec << std::endl;
+  for( unsigned c=0; c<RqstNumClasses; c++ ){
+    for( unsigned i=0; i<rqstQ[c].size(); i++ ){
+      RevMemOp *op = rqstQ[c][i].second;
+      std::cout << "rqstQ[" << c << "][" << i << "] = " << op->getOp() << " @ 0x"
+                << std::hex << op->getAddr() << std::dec
+                << "; physAddr = 0x" << std::hex << op->getPhysAddr()
+                << std::dec << std::endl;
+    }
   }
 #endif
 
@@ -1040,22 +1609,35 @@ void RevBasicMemCtrl::handleFlagResp(RevMemOp *op){
    }
 }
 
-unsigned RevBasicMemCtrl::getNumSplitRqsts(RevMemOp *op){
-  unsigned count = 0;
-  for (const auto& n : outstanding ){
-    if( n.second == op ){
-      count++;
+void RevBasicMemCtrl::handleReadResp(StandardMem::ReadResp* ev){
+  if( !pfRqsts.empty() ){
+    auto P = pfRqsts.find(ev->getID());
+    if( P != pfRqsts.end() ){
+      // the prefetched data is only needed in the cache hierarchy
+      auto L = pfLines.find(P->second);
+      if( L != pfLines.end() )
+        L->second.second = true;
+      pfRqsts.erase(P);
+      delete ev;
+      return ;
     }
   }
-  return count;
-}
 
-void RevBasicMemCtrl::handleReadResp(StandardMem::ReadResp* ev){
-  if( std::find(requests.begin(),requests.end(),ev->getID()) != requests.end() ){
-    requests.erase(std::find(requests.begin(),requests.end(),ev->getID()));
-    RevMemOp *op = outstanding[ev->getID()];
-    if( !op )
-      output->fatal(CALL_INFO, -1, "RevMemOp is null in handleReadResp\n" );
+  RevMemOp *op = takeRqst(ev->getID());
+  if( op ){
+    if( op->isAMO() && (op->getOp() == RevMemOp::MemOp::MemOpREADLOCK) ){
+      handleAMOResp(ev, op);
+      return ;
+    }
+    if( !mshrWaiters.empty() ){
+      auto M = mshrWaiters.find(ev->getID());
+      if( M != mshrWaiters.end() ){
+        handleMSHRResp(ev, M->second);
+        mshrWaiters.erase(M);
+        return ;
+      }
+    }
+    const RevMemOp::MemOp OpType = op->getOp();
 #ifdef _REV_DEBUG_
     std::cout << "handleReadResp : id=" << ev->getID() << " @Addr= 0x"
               << std::hex << op->getAddr() << std::dec << std::endl;
@@ -1076,14 +1658,14 @@ void RevBasicMemCtrl::handleReadResp(StandardMem::ReadResp* ev){
         target++;
       }
 
-      if( getNumSplitRqsts(op) == 1 ){
+      if( op->retireSplitRqst() == 0 ){
         // this was the last request to service, delete the op
         handleFlagResp(op);
+        recordLatency(op);
         delete op;
       }
-      outstanding.erase(ev->getID());
       delete ev;
-      num_read--;
+      retireRqst(OpType);
       return ;
     }
 
@@ -1095,21 +1677,97 @@ void RevBasicMemCtrl::handleReadResp(StandardMem::ReadResp* ev){
     }
     // determine if we need to sign/zero extend
     handleFlagResp(op);
+    recordLatency(op);
     delete op;
-    outstanding.erase(ev->getID());
     delete ev;
+    retireRqst(OpType);
   }else{
     output->fatal(CALL_INFO, -1, "Error : found unknown ReadResp\n");
   }
-  num_read--;
+}
+
+void RevBasicMemCtrl::handleAMOResp(StandardMem::ReadResp* ev, RevMemOp *op){
+  const uint32_t Size = op->getSize();
+  const StandardMem::Request::flags_t flags = op->getFlags();
+  const uint8_t *Operand = op->getBuf();
+  std::vector<uint8_t> NewBuf(Size);
+
+  // return the prior memory value and compute the value to store
+  if( Size == 4 ){
+    uint32_t Old = 0;
+    uint32_t Val = 0;
+    std::memcpy(&Old, &ev->data[0], sizeof(uint32_t));
+    std::memcpy(&Val, &Operand[0], sizeof(uint32_t));
+    if( (uint32_t)(flags) & (uint32_t)(RevCPU::RevFlag::F_SEXT64) ){
+      uint64_t *target = (uint64_t *)(op->getTarget());
+      *target = (uint64_t)((int64_t)((int32_t)(Old)));
+    }else{
+      std::memcpy(op->getTarget(), &Old, sizeof(uint32_t));
+    }
+    uint32_t New = RevAMOCompute(Old, Val, flags);
+    std::memcpy(&NewBuf[0], &New, sizeof(uint32_t));
+  }else if( Size == 8 ){
+    uint64_t Old = 0;
+    uint64_t Val = 0;
+    std::memcpy(&Old, &ev->data[0], sizeof(uint64_t));
+    std::memcpy(&Val, &Operand[0], sizeof(uint64_t));
+    std::memcpy(op->getTarget(), &Old, sizeof(uint64_t));
+    uint64_t New = RevAMOCompute(Old, Val, flags);
+    std::memcpy(&NewBuf[0], &New, sizeof(uint64_t));
+  }else{
+    output->fatal(CALL_INFO, -1, "Error : unsupported AMO size of %u bytes\n", Size);
+  }
+
+  // release the lock with the updated value
+  StandardMem::Request::flags_t TmpFlags = (hasCache && op->isCacheable()) ?
+                                           op->getStdFlags() : op->getNonCacheFlags();
+  StandardMem::Request *rqst = new Interfaces::StandardMem::WriteUnlock(op->getAddr(),
+                                                                        (uint64_t)(Size),
+                                                                        NewBuf,
+                                                                        false,
+                                                                        TmpFlags);
+  // the read half completes here; the write half is timed from now
+  recordLatency(op);
+  op->setOp(RevMemOp::MemOp::MemOpWRITEUNLOCK);
+  const uint64_t Now = getCycle();
+  op->setEnqueueCycle(Now);
+  op->setIssueCycle(Now);
+  trackRqst(rqst, op);
+  memIface->send(rqst);
+  recordStat(WriteUnlockInFlight,1);
+  num_writeunlock++;
+
+  delete ev;
+  num_readlock--;
+}
+
+void RevBasicMemCtrl::retireRqst(RevMemOp::MemOp Op){
+  switch(Op){
+  case RevMemOp::MemOp::MemOpREAD:
+    num_read--;
+    break;
+  case RevMemOp::MemOp::MemOpWRITE:
+    num_write--;
+    break;
+  case RevMemOp::MemOp::MemOpREADLOCK:
+    num_readlock--;
+    break;
+  case RevMemOp::MemOp::MemOpWRITEUNLOCK:
+    num_writeunlock--;
+    break;
+  case RevMemOp::MemOp::MemOpLOADLINK:
+  case RevMemOp::MemOp::MemOpSTORECOND:
+    num_llsc--;
+    break;
+  default:
+    break;
+  }
 }
 
 void RevBasicMemCtrl::handleWriteResp(StandardMem::WriteResp* ev){
-  if( std::find(requests.begin(),requests.end(),ev->getID()) != requests.end() ){
-    requests.erase(std::find(requests.begin(),requests.end(),ev->getID()));
-    RevMemOp *op = outstanding[ev->getID()];
-    if( !op )
-      output->fatal(CALL_INFO, -1, "RevMemOp is null in handleWriteResp\n" );
+  RevMemOp *op = takeRqst(ev->getID());
+  if( op ){
+    const RevMemOp::MemOp OpType = op->getOp();
 #ifdef _REV_DEBUG_
     std::cout << "handleWriteResp : id=" << ev->getID() << " @Addr= 0x"
               << std::hex << op->getAddr() << std::dec << std::endl;
@@ -1118,49 +1776,45 @@ void RevBasicMemCtrl::handleWriteResp(StandardMem::WriteResp* ev){
     // determine if we have a split request
     if( op->getSplitRqst() > 1 ){
       // split request exists, determine how to handle it
-      if( getNumSplitRqsts(op) == 1 ){
+      if( op->retireSplitRqst() == 0 ){
         // this was the last request to service, delete the op
+        recordLatency(op);
         delete op;
       }
-      outstanding.erase(ev->getID());
       delete ev;
-      num_write--;
+      retireRqst(OpType);
       return ;
     }
 
     // no split request exists; handle as normal
+    recordLatency(op);
     delete op;
-    outstanding.erase(ev->getID());
     delete ev;
+    retireRqst(OpType);
   }else{
     output->fatal(CALL_INFO, -1, "Error : found unknown WriteResp\n");
   }
-  num_write--;
 }
 
 void RevBasicMemCtrl::handleFlushResp(StandardMem::FlushResp* ev){
-  if( std::find(requests.begin(),requests.end(),ev->getID()) != requests.end() ){
-    requests.erase(std::find(requests.begin(),requests.end(),ev->getID()));
-    RevMemOp *op = outstanding[ev->getID()];
-    if( !op )
-      output->fatal(CALL_INFO, -1, "RevMemOp is null in handleFlushResp\n" );
-
+  RevMemOp *op = takeRqst(ev->getID());
+  if( op ){
     // determine if we have a split request
     if( op->getSplitRqst() > 1 ){
       // split request exists, determine how to handle it
-      if( getNumSplitRqsts(op) == 1 ){
+      if( op->retireSplitRqst() == 0 ){
         // this was the last request to service, delete the op
+        recordLatency(op);
         delete op;
       }
-      outstanding.erase(ev->getID());
       delete ev;
       num_flush--;
       return ;
     }
 
     // no split request exists; handle as normal
+    recordLatency(op);
     delete op;
-    outstanding.erase(ev->getID());
     delete ev;
   }else{
     output->fatal(CALL_INFO, -1, "Error : found unknown FlushResp\n");
@@ -1169,28 +1823,24 @@ void RevBasicMemCtrl::handleFlushResp(StandardMem::FlushResp* ev){
 }
 
 void RevBasicMemCtrl::handleCustomResp(StandardMem::CustomResp* ev){
-  if( std::find(requests.begin(),requests.end(),ev->getID()) != requests.end() ){
-    requests.erase(std::find(requests.begin(),requests.end(),ev->getID()));
-    RevMemOp *op = outstanding[ev->getID()];
-    if( !op )
-      output->fatal(CALL_INFO, -1, "RevMemOp is null in handleCustomResp\n" );
-
+  RevMemOp *op = takeRqst(ev->getID());
+  if( op ){
     // determine if we have a split request
     if( op->getSplitRqst() > 1 ){
       // split request exists, determine how to handle it
-      if( getNumSplitRqsts(op) == 1 ){
+      if( op->retireSplitRqst() == 0 ){
         // this was the last request to service, delete the op
+        recordLatency(op);
         delete op;
       }
-      outstanding.erase(ev->getID());
       delete ev;
       num_custom--;
       return ;
     }
 
     // no split request exists; handle as normal
+    recordLatency(op);
     delete op;
-    outstanding.erase(ev->getID());
     delete ev;
   }else{
     output->fatal(CALL_INFO, -1, "Error : found unknown CustomResp\n");
@@ -1199,27 +1849,21 @@ void RevBasicMemCtrl::handleCustomResp(StandardMem::CustomResp* ev){
 }
 
 void RevBasicMemCtrl::handleInvResp(StandardMem::InvNotify* ev){
-  if( std::find(requests.begin(),requests.end(),ev->getID()) != requests.end() ){
-    requests.erase(std::find(requests.begin(),requests.end(),ev->getID()));
-    RevMemOp *op = outstanding[ev->getID()];
-    if( !op )
-      output->fatal(CALL_INFO, -1, "RevMemOp is null in handleInvResp\n" );
-
+  RevMemOp *op = takeRqst(ev->getID());
+  if( op ){
     // determine if we have a split request
     if( op->getSplitRqst() > 1 ){
       // split request exists, determine how to handle it
-      if( getNumSplitRqsts(op) == 1 ){
+      if( op->retireSplitRqst() == 0 ){
         // this was the last request to service, delete the op
         delete op;
       }
-      outstanding.erase(ev->getID());
       delete ev;
       return ;
     }
 
     // no split request exists; handle as normal
     delete op;
-    outstanding.erase(ev->getID());
     delete ev;
   }else{
     output->fatal(CALL_INFO, -1, "Error : found unknown InvResp\n");
@@ -1232,23 +1876,15 @@ uint64_t RevBasicMemCtrl::getTotalRqsts(){
 }
 
 bool RevBasicMemCtrl::outstandingRqsts(){
-  return (requests.size() > 0 );
+  return !outstanding.empty() || !wbuf.empty();
 }
 
-bool RevBasicMemCtrl::clockTick(Cycle_t cycle){
+uint64_t RevBasicMemCtrl::getNumPendingRqsts(){
+  return numQueued + (uint64_t)(outstanding.size()) + (uint64_t)(wbuf.size());
+}
 
-  // check to see if the top request is a FENCE
-  if( num_fence > 0 ){
-    if( (num_read + num_write + num_llsc +
-         num_readlock + num_writeunlock + num_custom) != 0 ){
-      // waiting for the outstanding ops to clear
-      recordStat(RevBasicMemCtrl::MemCtrlStats::FencePending,1);
-      return false;
-    }else{
-      // clear the fence and continue processing
-      num_fence--;
-    }
-  }
+bool RevBasicMemCtrl::clockTick(Cycle_t cycle){
+  curCycle = cycle;
 
   // process the memory queue
   bool done = false;
@@ -1260,11 +1896,27 @@ bool RevBasicMemCtrl::clockTick(Cycle_t cycle){
   unsigned t_max_readlock = 0;
   unsigned t_max_writeunlock = 0;
   unsigned t_max_custom = 0;
+  unsigned t_idle_ops = 0;
+
+  // check to see if the top request is a FENCE
+  if( num_fence > 0 ){
+    // a fence also waits for every posted write to reach memory
+    drainWBuf(t_max_stores, true);
+    if( ((num_read + num_write + num_llsc +
+          num_readlock + num_writeunlock + num_custom) != 0) || !wbuf.empty() ){
+      // waiting for the outstanding ops to clear
+      recordStat(RevBasicMemCtrl::MemCtrlStats::FencePending,1);
+      return false;
+    }else{
+      // clear the fence and continue processing
+      num_fence--;
+    }
+  }
 
   while( !done ){
     if( !processNextRqst(t_max_loads, t_max_stores, t_max_flush,
                          t_max_llsc, t_max_readlock, t_max_writeunlock,
-                         t_max_custom, t_max_ops) ){
+                         t_max_custom, t_max_ops, t_idle_ops) ){
       // error occurred
       output->fatal(CALL_INFO, -1, "Error : failed to process next memory request");
     }
@@ -1274,6 +1926,23 @@ bool RevBasicMemCtrl::clockTick(Cycle_t cycle){
     }
   }
 
+  // retire posted writes with the store slots left this cycle
+  drainWBuf(t_max_stores, false);
+
+  if( prefetcher )
+    issuePrefetches(t_max_loads, t_idle_ops);
+
+  recordStat(ReadOutstanding, num_read);
+  recordStat(WriteOutstanding, num_write);
+  recordStat(PrefetchOutstanding, (uint64_t)(pfRqsts.size()));
+
+  // release the clock until a new request is queued; responses to
+  // in-flight requests arrive through the memory interface handler
+  if( isIdle() ){
+    clockActive = false;
+    return true;
+  }
+
   return false;
 }
 
@@ -0,0 +1,178 @@
+//
+// _RevMemTrace_cc_
+//
+// Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+//
+// See LICENSE in the top level directory for licensing details
+//
+
+#include "../include/RevMemTrace.h"
+#include <cstring>
+
+using namespace SST;
+using namespace RevCPU;
+
+RevMemTrace::RevMemTrace( const std::string &File, uint64_t BufSize, SST::Output *Output )
+  : file(nullptr), bufSize(BufSize), output(Output), minAddr(0),
+    maxAddr(~0ull), startCycle(0), stopCycle(~0ull), numRecords(0),
+    done(false){
+
+  if( bufSize == 0 )
+    output->fatal(CALL_INFO, -1, "Error: memory trace buffer size must be non-zero\n");
+
+  file = fopen(File.c_str(), "wb");
+  if( !file )
+    output->fatal(CALL_INFO, -1, "Error: could not open memory trace file %s\n", File.c_str());
+
+  const uint8_t Version = _REV_TRACE_VERSION_;
+  fwrite(_REV_TRACE_MAGIC_, 1, strlen(_REV_TRACE_MAGIC_), file);
+  fwrite(&Version, 1, 1, file);
+
+  std::memset(&prev, 0, sizeof(prev));
+  cur.reserve(bufSize + 64);
+  writer = std::thread(&RevMemTrace::WriterLoop, this);
+}
+
+RevMemTrace::~RevMemTrace(){
+  Flush();
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    done = true;
+  }
+  cv.notify_one();
+  writer.join();
+  fclose(file);
+}
+
+void RevMemTrace::Record( const RevTraceRecord &R ){
+  const bool Ctx = (R.Core != prev.Core) || (R.Hart != prev.Hart) || (numRecords == 0);
+  uint8_t Hdr = (uint8_t)(R.Op);
+  if( Ctx )
+    Hdr |= HDR_CTX;
+  if( R.Flags != 0 )
+    Hdr |= HDR_FLAGS;
+
+  cur.push_back(Hdr);
+  PutDelta(R.Cycle, prev.Cycle);
+  if( Ctx ){
+    PutVarint(R.Core);
+    PutVarint(R.Hart);
+  }
+  PutDelta(R.PC, prev.PC);
+  PutDelta(R.VAddr, prev.VAddr);
+  PutDelta(R.PAddr - R.VAddr, prev.PAddr - prev.VAddr);
+  PutVarint(R.Size);
+  if( R.Flags != 0 )
+    PutVarint(R.Flags);
+
+  prev = R;
+  numRecords++;
+  if( cur.size() >= bufSize )
+    Flush();
+}
+
+void RevMemTrace::Flush(){
+  if( cur.empty() )
+    return ;
+  std::unique_lock<std::mutex> lock(mtx);
+  // apply backpressure rather than buffering without bound
+  drained.wait(lock, [this]{ return full.size() < _REV_TRACE_QUEUE_; });
+  full.push_back(std::move(cur));
+  if( !spare.empty() ){
+    cur = std::move(spare.back());
+    spare.pop_back();
+  }else{
+    cur = std::vector<uint8_t>();
+    cur.reserve(bufSize + 64);
+  }
+  lock.unlock();
+  cv.notify_one();
+}
+
+void RevMemTrace::WriterLoop(){
+  std::unique_lock<std::mutex> lock(mtx);
+  while( true ){
+    cv.wait(lock, [this]{ return done || !full.empty(); });
+    if( full.empty() && done )
+      break;
+    std::vector<uint8_t> Buf = std::move(full.front());
+    full.pop_front();
+    lock.unlock();
+    drained.notify_one();
+
+    if( fwrite(Buf.data(), 1, Buf.size(), file) != Buf.size() )
+      output->fatal(CALL_INFO, -1, "Error: failed writing the memory trace\n");
+
+    Buf.clear();
+    lock.lock();
+    spare.push_back(std::move(Buf));
+  }
+}
+
+RevMemTraceReader::RevMemTraceReader( const std::string &File, SST::Output *Output )
+  : file(nullptr), output(Output), numRecords(0), pos(0), len(0){
+
+  file = fopen(File.c_str(), "rb");
+  if( !file )
+    output->fatal(CALL_INFO, -1, "Error: could not open memory trace file %s\n", File.c_str());
+
+  char Magic[sizeof(_REV_TRACE_MAGIC_)] = {};
+  uint8_t Version = 0;
+  if( (fread(Magic, 1, strlen(_REV_TRACE_MAGIC_), file) != strlen(_REV_TRACE_MAGIC_)) ||
+      (strcmp(Magic, _REV_TRACE_MAGIC_) != 0) ||
+      (fread(&Version, 1, 1, file) != 1) )
+    output->fatal(CALL_INFO, -1, "Error: %s is not a memory trace\n", File.c_str());
+  if( Version != _REV_TRACE_VERSION_ )
+    output->fatal(CALL_INFO, -1, "Error: unsupported memory trace version %u in %s\n",
+                  (unsigned)(Version), File.c_str());
+
+  std::memset(&prev, 0, sizeof(prev));
+  buf.resize(1048576);
+}
+
+RevMemTraceReader::~RevMemTraceReader(){
+  if( file )
+    fclose(file);
+}
+
+uint64_t RevMemTraceReader::GetVarint(){
+  uint64_t V = 0;
+  unsigned Shift = 0;
+  uint8_t B = 0;
+  do{
+    if( !GetByte(B) || (Shift > 63) )
+      output->fatal(CALL_INFO, -1, "Error: truncated memory trace after %" PRIu64 " records\n", numRecords);
+    V |= (uint64_t)(B & 0x7F) << Shift;
+    Shift += 7;
+  }while( B & 0x80 );
+  return V;
+}
+
+bool RevMemTraceReader::Next( RevTraceRecord &R ){
+  uint8_t Hdr = 0;
+  if( !GetByte(Hdr) )
+    return false;
+
+  R.Op    = (RevTraceOp)(Hdr & 0x0F);
+  R.Cycle = GetDelta(prev.Cycle);
+  if( Hdr & RevMemTrace::HDR_CTX ){
+    R.Core = (unsigned)(GetVarint());
+    R.Hart = (unsigned)(GetVarint());
+  }else{
+    R.Core = prev.Core;
+    R.Hart = prev.Hart;
+  }
+  R.PC    = GetDelta(prev.PC);
+  R.VAddr = GetDelta(prev.VAddr);
+  R.PAddr = R.VAddr + GetDelta(prev.PAddr - prev.VAddr);
+  R.Size  = (uint32_t)(GetVarint());
+  R.Flags = (Hdr & RevMemTrace::HDR_FLAGS) ? (uint32_t)(GetVarint()) : 0;
+
+  prev = R;
+  numRecords++;
+  return true;
+}
+
+// EOF
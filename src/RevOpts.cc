@@ -208,6 +208,31 @@ bool RevOpts::InitMemCosts( std::vector<std::string> MemCosts ){
   return true;
 }
 
+bool RevOpts::InitMemRegions( std::vector<std::string> Regions ){
+  std::vector<std::string> vstr;
+
+  // each region is Base:Size:Min:Max with an optional :Bandwidth
+  for( unsigned i=0; i<Regions.size(); i++ ){
+    std::string s = Regions[i];
+    splitStr(s,':',vstr);
+    if( (vstr.size() != 4) && (vstr.size() != 5) )
+      return false;
+
+    RevMemRegion R;
+    R.Base      = (uint64_t)(std::stoull(vstr[0],nullptr,0));
+    R.Size      = (uint64_t)(std::stoull(vstr[1],nullptr,0));
+    R.MinCost   = (unsigned)(std::stoi(vstr[2],nullptr,0));
+    R.MaxCost   = (unsigned)(std::stoi(vstr[3],nullptr,0));
+    R.Bandwidth = (vstr.size() == 5) ? (uint64_t)(std::stoull(vstr[4],nullptr,0)) : 0;
+    if( (R.Size == 0) || (R.MaxCost == 0) || (R.MinCost > R.MaxCost) )
+      return false;
+    memRegions.push_back(R);
+    vstr.clear();
+  }
+
+  return true;
+}
+
 bool RevOpts::GetPrefetchDepth( unsigned Core, unsigned &Depth ){
   if( Core > numCores )
     return false;
@@ -0,0 +1,90 @@
+//
+// _RevPageTable_cc_
+//
+// Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+//
+// See LICENSE in the top level directory for licensing details
+//
+
+#include "../include/RevPageTable.h"
+
+using namespace SST;
+using namespace RevCPU;
+
+RevPageTable::RevPageTable( unsigned VPNBits, unsigned BitsPerLevel, SST::Output *Output )
+  : levels(0), bits(BitsPerLevel), rootBits(0), levelMask(0), numMapped(0),
+    root(nullptr), lastLeafTag(_INVALID_ADDR_), lastLeaf(nullptr), output(Output){
+
+  if( (bits == 0) || (bits > 24) )
+    output->fatal(CALL_INFO, -1,
+                  "Error: page table bits per level must be between 1 and 24; bits=%u\n", bits);
+  if( (VPNBits == 0) || (VPNBits > 64) )
+    output->fatal(CALL_INFO, -1,
+                  "Error: invalid number of virtual page number bits; VPNBits=%u\n", VPNBits);
+
+  // the root absorbs the remainder so that every other level is uniform
+  levels = (VPNBits + bits - 1) / bits;
+  if( levels < 2 )
+    levels = 2;
+  rootBits = (VPNBits > (levels-1)*bits) ? (VPNBits - (levels-1)*bits) : 0;
+  levelMask = (1ull << bits) - 1;
+
+  root = new void* [1ull << rootBits]();
+}
+
+RevPageTable::~RevPageTable(){
+  FreeNode(root, 0);
+}
+
+void RevPageTable::FreeNode( void **Node, unsigned Level ){
+  if( !Node )
+    return ;
+  if( Level == levels-1 ){
+    delete[] (RevPTE *)(Node);
+    return ;
+  }
+  const uint64_t Entries = (Level == 0) ? (1ull << rootBits) : (1ull << bits);
+  for( uint64_t i=0; i<Entries; i++ ){
+    FreeNode((void **)(Node[i]), Level+1);
+  }
+  delete[] Node;
+}
+
+RevPTE *RevPageTable::Walk( uint64_t VPN ){
+  RevPTE *PTE = Find(VPN);
+  if( PTE )
+    return PTE;
+
+  // first touch of this region; populate the missing nodes
+  void **Node = root;
+  for( unsigned l=0; l<levels-1; l++ ){
+    void *&Next = Node[Index(VPN, l)];
+    if( !Next ){
+      if( l == levels-2 ){
+        RevPTE *Leaf = new RevPTE [1ull << bits];
+        for( uint64_t i=0; i<(1ull << bits); i++ ){
+          Leaf[i].PPN = _INVALID_ADDR_;
+          Leaf[i].Flags = 0x00;
+          Leaf[i].Reads = 0;
+          Leaf[i].Writes = 0;
+          Leaf[i].FirstTouch = 0;
+          Leaf[i].LastTouch = 0;
+          Leaf[i].Cores = 0;
+          Leaf[i].Interval = 0;
+        }
+        Next = (void *)(Leaf);
+      }else{
+        Next = (void *)(new void* [1ull << bits]());
+      }
+    }
+    Node = (void **)(Next);
+  }
+
+  lastLeafTag = VPN >> bits;
+  lastLeaf = (RevPTE *)(Node);
+  return &lastLeaf[VPN & levelMask];
+}
+
+// EOF
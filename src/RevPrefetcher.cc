@@ -183,11 +183,39 @@ void RevPrefetcher::Fill(uint64_t Addr){
   for( unsigned y=0; y<depth; y++ ){
     mem->ReadVal( Addr+(y*4),
                   (uint32_t *)(&iStack[x][y]),
-                  REVMEM_FLAGS(0x00) );
+                  REVMEM_FLAGS(RevFlag::F_IFETCH) );
 
   }
 }
 
+void RevPrefetcher::Checkpoint(RevCheckpoint &C){
+  C.Section("RevPrefetcher");
+  C.Put<uint32_t>(depth);
+  C.PutVec(baseAddr);
+  for( unsigned i=0; i<iStack.size(); i++ ){
+    C.PutBytes(iStack[i], depth*sizeof(uint32_t));
+  }
+}
+
+void RevPrefetcher::Restore(RevCheckpoint &C){
+  C.Section("RevPrefetcher");
+  while( !baseAddr.empty() )
+    DeleteStream(baseAddr.size()-1);
+
+  const unsigned Depth = C.Get<uint32_t>();
+  const std::vector<uint64_t> Streams = C.GetVec<uint64_t>();
+  for( unsigned i=0; i<Streams.size(); i++ ){
+    // a different stream depth drops the streams; they refill on the next fetch
+    if( Depth != depth ){
+      C.Skip(Depth*sizeof(uint32_t));
+      continue;
+    }
+    baseAddr.push_back(Streams[i]);
+    iStack.push_back( new uint32_t[depth] );
+    C.GetBytes(iStack.back(), depth*sizeof(uint32_t));
+  }
+}
+
 void RevPrefetcher::DeleteStream(unsigned i){
   // delete the target stream as we no longer need it
   if( i > (baseAddr.size()-1) ){
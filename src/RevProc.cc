@@ -96,11 +96,78 @@ RevProc::RevProcStats RevProc::GetStats(){
   Stats.memStats.doublesWritten = mem->memStats.doublesWritten;
   Stats.memStats.floatsRead     = mem->memStats.floatsRead;
   Stats.memStats.floatsWritten  = mem->memStats.floatsWritten;
-  Stats.memStats.TLBMisses      = mem->memStats.TLBMisses;
-  Stats.memStats.TLBHits        = mem->memStats.TLBHits;
+  Stats.memStats.TLBMisses      = mem->GetTLB(id)->GetMisses();
+  Stats.memStats.TLBHits        = mem->GetTLB(id)->GetHits();
+  Stats.memStats.SCAttempts     = mem->GetSCAttempts(id);
+  Stats.memStats.SCFailures     = mem->GetSCFailures(id);
+  Stats.memStats.L1Hits         = mem->GetCacheHits(0, id);
+  Stats.memStats.L1Misses       = mem->GetCacheMisses(0, id);
+  Stats.memStats.L2Hits         = mem->GetCacheHits(1, id);
+  Stats.memStats.L2Misses       = mem->GetCacheMisses(1, id);
+  Stats.memStats.RegionAccesses = mem->GetRegionAccesses(id);
+  Stats.memStats.RegionStalls   = mem->GetRegionStalls(id);
   return Stats;
 }
 
+void RevProc::Checkpoint(RevCheckpoint &C){
+  if( !IsQuiescent() )
+    output->fatal(CALL_INFO, -1, "Error: core %d cannot be checkpointed with instructions in flight\n", id);
+
+  C.Section("RevProc");
+  C.Put<uint32_t>(id);
+  C.Put(Halted);
+  C.Put(Stalled);
+  C.Put(SingleStep);
+  C.Put(ExecPC);
+  C.Put(HartToDecode);
+  C.Put(HartToExec);
+  C.Put(Retired);
+  C.Put(SwapToParent);
+  C.Put(Stats);
+  C.Put<uint64_t>(HART_CTE.to_ullong());
+  C.PutVec(ActivePIDs);
+
+  // write the contexts in PID order so that identical states produce identical files
+  std::vector<uint32_t> PIDs;
+  for( auto &T : ThreadTable )
+    PIDs.push_back(T.first);
+  std::sort(PIDs.begin(), PIDs.end());
+  C.Put<uint64_t>(PIDs.size());
+  for( uint32_t PID : PIDs )
+    ThreadTable[PID]->Checkpoint(C);
+
+  sfetch->Checkpoint(C);
+}
+
+void RevProc::Restore(RevCheckpoint &C){
+  C.Section("RevProc");
+  const unsigned Id = C.Get<uint32_t>();
+  if( Id != id )
+    output->fatal(CALL_INFO, -1, "Error: checkpoint holds core %u where core %d was expected\n", Id, id);
+  Halted = C.Get<bool>();
+  Stalled = C.Get<bool>();
+  SingleStep = C.Get<bool>();
+  ExecPC = C.Get<uint64_t>();
+  HartToDecode = C.Get<uint16_t>();
+  HartToExec = C.Get<uint16_t>();
+  Retired = C.Get<uint64_t>();
+  SwapToParent = C.Get<bool>();
+  Stats = C.Get<RevProcStats>();
+  HART_CTE = std::bitset<_REV_HART_COUNT_>(C.Get<uint64_t>());
+  ActivePIDs = C.GetVec<uint32_t>();
+
+  ThreadTable.clear();
+  const uint64_t NumCtx = C.Get<uint64_t>();
+  for( uint64_t i=0; i<NumCtx; i++ ){
+    std::shared_ptr<RevThreadCtx> Ctx = std::make_shared<RevThreadCtx>(0, 0);
+    Ctx->Restore(C);
+    ThreadTable.emplace(Ctx->GetPID(), Ctx);
+  }
+  RegFile = GetRegFile(HartToDecode);
+
+  sfetch->Restore(C);
+}
+
 bool RevProc::Halt(){
   if( Halted )
     return false;
@@ -1791,6 +1858,10 @@ bool RevProc::ClockTick( SST::Cycle_t currentCycle ){
   bool rtn = false;
   Stats.totalCycles++;
 
+  // route translations through this core's TLB
+  mem->SetActiveCore(id);
+  mem->SetCycle(currentCycle);
+
 #ifdef _REV_DEBUG_
   if((currentCycle % 100000000) == 0){
     std::cout << "Current Cycle: " << currentCycle <<  " PC: "
@@ -1843,6 +1914,7 @@ bool RevProc::ClockTick( SST::Cycle_t currentCycle ){
     }else{
       Stalled = false;
     }
+    mem->SetFetchStall(id, Stalled);
 
     // If the next instruction is our special bounce address
     // DO NOT decode it.  It will decode to a bogus instruction.
@@ -1902,6 +1974,7 @@ bool RevProc::ClockTick( SST::Cycle_t currentCycle ){
 
 
       // execute the instruction
+      mem->SetActiveHart(HartToExec, ExecPC);
       if( !Ext->Execute(EToE.second, Inst, HartToExec) ){
         output->fatal(CALL_INFO, -1,
                     "Error: failed to execute instruction at PC=%" PRIx64 ".", ExecPC );
@@ -2033,6 +2106,9 @@ bool RevProc::ClockTick( SST::Cycle_t currentCycle ){
 
     rtn = true;
   }else{
+    // a halted core or one with no ready hart is not waiting on fetch
+    mem->SetFetchStall(id, false);
+
     // wait until the counter has been decremented
     // note that this will continue to occur until the counter is drained
     // and the HART is halted
@@ -2140,20 +2216,21 @@ bool RevProc::ClockTick( SST::Cycle_t currentCycle ){
     }
     if( done ){
       // we are really done, return
+      mem->SetFetchStall(id, false);
       output->verbose(CALL_INFO,2,0,"Program execution complete\n");
       Stats.percentEff = float(Stats.cyclesBusy)/Stats.totalCycles;
       output->verbose(CALL_INFO,2,0,
                       "Program Stats: Total Cycles: %" PRIu64 " Busy Cycles: %" PRIu64 " Idle Cycles: %" PRIu64 " Eff: %f\n",
                       Stats.totalCycles, Stats.cyclesBusy,
                       Stats.cyclesIdle_Total, Stats.percentEff);
-      output->verbose(CALL_INFO,3,0,"\t Bytes Read: %d Bytes Written: %d Floats Read: %d Doubles Read %d Floats Exec: %" PRIu64 " TLB Hits: %" PRIu64 " TLB Misses: %" PRIu64 " Inst Retired: %" PRIu64 "\n",
+      output->verbose(CALL_INFO,3,0,"\t Bytes Read: %" PRIu64 " Bytes Written: %" PRIu64 " Floats Read: %" PRIu64 " Doubles Read %" PRIu64 " Floats Exec: %" PRIu64 " TLB Hits: %" PRIu64 " TLB Misses: %" PRIu64 " Inst Retired: %" PRIu64 "\n",
                                       mem->memStats.bytesRead,
                                       mem->memStats.bytesWritten,
                                       mem->memStats.floatsRead,
                                       mem->memStats.doublesRead,
                                       Stats.floatsExec,
-                                      mem->memStats.TLBHits,
-                                      mem->memStats.TLBMisses,
+                                      mem->GetTLB(id)->GetHits(),
+                                      mem->GetTLB(id)->GetMisses(),
                                       Retired);
       return false;
     }
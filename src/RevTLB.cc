@@ -0,0 +1,81 @@
+//
+// _RevTLB_cc_
+//
+// Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+// All Rights Reserved
+// contact@tactcomplabs.com
+//
+// See LICENSE in the top level directory for licensing details
+//
+
+#include "../include/RevTLB.h"
+
+using namespace SST;
+using namespace RevCPU;
+
+RevTLB::RevTLB( unsigned Entries, unsigned Ways, SST::Output *Output )
+  : sets(0), ways(Ways), setMask(0), fullMask(0), hits(0), misses(0),
+    output(Output){
+
+  if( (ways == 0) || (ways > 64) )
+    output->fatal(CALL_INFO, -1, "Error: TLB associativity must be between 1 and 64; ways=%u\n", ways);
+
+  if( (Entries < ways) || (Entries % ways) != 0 )
+    output->fatal(CALL_INFO, -1, "Error: TLB size (%u) must be a multiple of the associativity (%u)\n",
+                  Entries, ways);
+
+  sets = Entries / ways;
+  if( (sets & (sets-1)) != 0 )
+    output->fatal(CALL_INFO, -1, "Error: number of TLB sets must be a power of two; sets=%u\n", sets);
+
+  setMask = (uint64_t)(sets-1);
+  fullMask = (ways == 64) ? ~0ull : ((1ull << ways) - 1);
+
+  Tags.resize(sets*ways);
+  PPNs.resize(sets*ways);
+  MRU.resize(sets);
+  Flush();
+}
+
+RevTLB::~RevTLB(){
+}
+
+void RevTLB::Flush(){
+  std::fill(Tags.begin(), Tags.end(), _INVALID_ADDR_);
+  std::fill(PPNs.begin(), PPNs.end(), _INVALID_ADDR_);
+  std::fill(MRU.begin(), MRU.end(), 0x00ull);
+}
+
+uint64_t RevTLB::Insert( uint64_t VPN, uint64_t PPN ){
+  const unsigned Base = (unsigned)(VPN & setMask) * ways;
+
+  // if the page is already present, this is an update rather than a fill
+  for( unsigned w=0; w<ways; w++ ){
+    if( Tags[Base+w] == VPN ){
+      PPNs[Base+w] = PPN;
+      Touch(Base, w);
+      return _INVALID_ADDR_;
+    }
+  }
+
+  // prefer an invalid way, otherwise evict the first way without its MRU bit
+  unsigned Victim = ways;
+  for( unsigned w=0; w<ways; w++ ){
+    if( Tags[Base+w] == _INVALID_ADDR_ ){
+      Victim = w;
+      break;
+    }
+  }
+  if( Victim == ways ){
+    const uint64_t Cold = ~MRU[Base/ways] & fullMask;
+    Victim = (Cold == 0) ? 0 : (unsigned)(__builtin_ctzll(Cold));
+  }
+
+  const uint64_t Evicted = Tags[Base+Victim];
+  Tags[Base+Victim] = VPN;
+  PPNs[Base+Victim] = PPN;
+  Touch(Base, Victim);
+  return Evicted;
+}
+
+// EOF
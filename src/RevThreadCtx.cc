@@ -94,4 +94,24 @@ bool RevThreadCtx::RemoveFD(int fd){
   return false;  
 }
 
+/* Write the Ctx to a checkpoint; host file descriptors are recorded but not reopened */
+void RevThreadCtx::Checkpoint(RevCheckpoint& C){
+  C.Section("RevThreadCtx");
+  C.Put<uint32_t>(PID);
+  C.Put<uint32_t>(ParentPID);
+  C.Put<uint32_t>((uint32_t)(State));
+  C.PutBytes(&RegFile, sizeof(RegFile));
+  C.PutVec(ChildrenPIDs);
+  C.PutVec(fildes);
+}
 
+/* Restore the Ctx from a checkpoint */
+void RevThreadCtx::Restore(RevCheckpoint& C){
+  C.Section("RevThreadCtx");
+  PID = C.Get<uint32_t>();
+  ParentPID = C.Get<uint32_t>();
+  State = (ThreadState)(C.Get<uint32_t>());
+  C.GetBytes(&RegFile, sizeof(RegFile));
+  ChildrenPIDs = C.GetVec<uint32_t>();
+  fildes = C.GetVec<int>();
+}
@@ -0,0 +1,79 @@
+/*
+ * amo.c
+ *
+ * RISC-V ISA: RV64IMAFD
+ *
+ * Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ *
+ */
+
+#include <stdint.h>
+
+#define assert(x)                                                              \
+  if (!(x)) {                                                                  \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+  }
+
+volatile int32_t w = 5;
+volatile uint32_t uw = 5;
+volatile int64_t d = 5;
+volatile uint64_t ud = 5;
+
+int main() {
+  int32_t r32;
+  int64_t r64;
+  uint64_t rd;
+
+  // 32-bit operations; each returns the prior memory value
+  asm volatile("amoadd.w %0, %2, (%1)" : "=r"(r32) : "r"(&w), "r"(7) : "memory");
+  assert(r32 == 5);
+  assert(w == 12);
+  asm volatile("amoxor.w %0, %2, (%1)" : "=r"(r32) : "r"(&w), "r"(0xF) : "memory");
+  assert(r32 == 12);
+  assert(w == 3);
+  asm volatile("amoand.w %0, %2, (%1)" : "=r"(r32) : "r"(&w), "r"(0x2) : "memory");
+  assert(w == 2);
+  asm volatile("amoor.w %0, %2, (%1)" : "=r"(r32) : "r"(&w), "r"(0x8) : "memory");
+  assert(w == 10);
+  asm volatile("amomin.w %0, %2, (%1)" : "=r"(r32) : "r"(&w), "r"(-4) : "memory");
+  assert(w == -4);
+  asm volatile("amomax.w %0, %2, (%1)" : "=r"(r32) : "r"(&w), "r"(3) : "memory");
+  assert(r32 == -4);
+  assert(w == 3);
+  asm volatile("amoswap.w %0, %2, (%1)" : "=r"(r64) : "r"(&w), "r"(-1) : "memory");
+  assert(r64 == 3);
+  asm volatile("amoswap.w %0, %2, (%1)" : "=r"(r64) : "r"(&w), "r"(0) : "memory");
+  assert(r64 == -1);
+  asm volatile("amominu.w %0, %2, (%1)" : "=r"(r32) : "r"(&uw), "r"(2) : "memory");
+  assert(uw == 2);
+  asm volatile("amomaxu.w %0, %2, (%1)" : "=r"(r32) : "r"(&uw), "r"(-1) : "memory");
+  assert(uw == 0xFFFFFFFF);
+
+  // 64-bit operations
+  asm volatile("amoadd.d %0, %2, (%1)" : "=r"(r64) : "r"(&d), "r"(0x100000000ll) : "memory");
+  assert(r64 == 5);
+  assert(d == 0x100000005ll);
+  asm volatile("amomin.d %0, %2, (%1)" : "=r"(r64) : "r"(&d), "r"(-9ll) : "memory");
+  assert(d == -9);
+  asm volatile("amomaxu.d %0, %2, (%1)" : "=r"(rd) : "r"(&ud), "r"(~0ull) : "memory");
+  assert(rd == 5);
+  assert(ud == ~0ull);
+  asm volatile("amoswap.d %0, %2, (%1)" : "=r"(rd) : "r"(&ud), "r"(1) : "memory");
+  assert(rd == ~0ull);
+  assert(ud == 1);
+
+  // compiler generated atomics
+  __atomic_fetch_add(&d, 10, __ATOMIC_SEQ_CST);
+  assert(d == 1);
+  assert(__atomic_fetch_sub(&w, 1, __ATOMIC_SEQ_CST) == 0);
+  assert(w == -1);
+
+  return 0;
+}
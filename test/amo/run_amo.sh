@@ -0,0 +1,12 @@
+#!/bin/bash
+
+#Build the test
+make
+
+# Check that the exec was built...
+if [ -f amo.exe ]; then
+  sst --add-lib-path=../../src/ ./rev-amo.py
+else
+  echo "Test AMO: amo.exe not Found - likely build failed"
+  exit 1
+fi
@@ -0,0 +1,50 @@
+/*
+ * cache_model.c
+ *
+ * RISC-V ISA: RV64IMAFD
+ *
+ * Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ *
+ */
+
+#include <stdint.h>
+
+#define assert(x)                                                              \
+  if (!(x)) {                                                                  \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+  }
+
+#define N 8192
+
+uint64_t a[N];
+
+int main() {
+  uint64_t sum = 0;
+
+  // unit stride; mostly hits once each line is resident
+  for( unsigned i=0; i<N; i++ ){
+    a[i] = i;
+  }
+  for( unsigned i=0; i<N; i++ ){
+    sum += a[i];
+  }
+  assert(sum == ((uint64_t)(N)*(N-1))/2);
+
+  // line stride across a footprint larger than the L1
+  sum = 0;
+  for( unsigned j=0; j<8; j++ ){
+    for( unsigned i=j; i<N; i+=8 ){
+      sum += a[i];
+    }
+  }
+  assert(sum == ((uint64_t)(N)*(N-1))/2);
+
+  return 0;
+}
@@ -0,0 +1,12 @@
+#!/bin/bash
+
+#Build the test
+make
+
+# Check that the exec was built...
+if [ -f cache_model.exe ]; then
+  sst --add-lib-path=../../src/ ./rev-cache-model.py
+else
+  echo "Test CACHE_MODEL: cache_model.exe not Found - likely build failed"
+  exit 1
+fi
@@ -0,0 +1,93 @@
+#!/bin/bash
+#
+# Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+# All Rights Reserved
+# contact@tactcomplabs.com
+#
+# See LICENSE in the top level directory for licensing details
+#
+# check_stats.sh
+#
+# Checks the statistics recorded in an SST CSV statistics file:
+#
+#   check_stats.sh <TEST> <file.csv> "<operand> <op> <operand>" ...
+#
+# An operand is a number or Name[:SubId][.Field], where Field is one
+# of the statistic columns (Sum, SumSQ, Count, Min, Max) and defaults
+# to Sum.  Rows with the same name and sub-id are combined.  Each
+# failed check prints "Test <TEST>: CHECK FAILED: ..."; the script
+# exits 1 if any check failed.
+#
+
+TEST=$1
+CSV=$2
+shift 2
+
+if [ ! -s "$CSV" ]; then
+  echo "Test $TEST: CHECK FAILED: $CSV was not written"
+  exit 1
+fi
+
+STATUS=0
+for CHECK in "$@"; do
+  if ! awk -F, -v Test="$TEST" -v Check="$CHECK" '
+       function trim(s){ gsub(/^ +| +$/, "", s); return s }
+       function value(Op,    Name, Sub, Field, K){
+         if( Op ~ /^-?[0-9]+$/ )
+           return Op + 0
+         Field = "Sum"
+         if( match(Op, /\.[A-Za-z]+$/) ){
+           Field = substr(Op, RSTART + 1)
+           Op = substr(Op, 1, RSTART - 1)
+         }
+         Name = Op; Sub = ""
+         if( index(Op, ":") ){
+           Name = substr(Op, 1, index(Op, ":") - 1)
+           Sub = substr(Op, index(Op, ":") + 1)
+         }
+         K = Name SUBSEP Sub SUBSEP Field
+         if( !(K in Val) ){
+           printf("Test %s: CHECK FAILED: %s was never recorded\n", Test, Op)
+           Missing = 1
+           return 0
+         }
+         return Val[K]
+       }
+       NR == 1 {
+         for( i=1; i<=NF; i++ ){
+           H = trim($i)
+           if( H == "StatisticName" ) NameCol = i
+           else if( H == "StatisticSubId" ) SubCol = i
+           else if( index(H, ".") ) Col[i] = substr(H, 1, index(H, ".") - 1)
+         }
+         next
+       }
+       {
+         for( i in Col ){
+           K = trim($NameCol) SUBSEP trim($SubCol) SUBSEP Col[i]
+           V = trim($i) + 0
+           if( !(K in Val) ) Val[K] = V
+           else if( Col[i] == "Max" ) { if( V > Val[K] ) Val[K] = V }
+           else if( Col[i] == "Min" ) { if( V < Val[K] ) Val[K] = V }
+           else Val[K] += V
+         }
+       }
+       END {
+         if( split(Check, T, " ") != 3 ){
+           printf("Test %s: CHECK FAILED: malformed check \"%s\"\n", Test, Check)
+           exit 1
+         }
+         L = value(T[1]); R = value(T[3])
+         if( Missing )
+           exit 1
+         if( !((T[2] == "<"  && L <  R) || (T[2] == "<=" && L <= R) ||
+               (T[2] == ">"  && L >  R) || (T[2] == ">=" && L >= R) ||
+               (T[2] == "==" && L == R)) ){
+           printf("Test %s: CHECK FAILED: %s (%.0f %s %.0f)\n", Test, Check, L, T[2], R)
+           exit 1
+         }
+       }' "$CSV"; then
+    STATUS=1
+  fi
+done
+exit $STATUS
@@ -0,0 +1,40 @@
+/*
+ * checkpoint.c
+ *
+ * RISC-V ISA: RV64IMAFD
+ *
+ * Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ *
+ */
+
+#include <stdint.h>
+
+#define assert(x)                                                              \
+  if (!(x)) {                                                                  \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+  }
+
+#define N 1024
+
+uint64_t a[N];
+
+int main() {
+  // the checkpoint is taken part way through these loops; the
+  // restored run must finish with the same memory and registers
+  uint64_t sum = 0;
+  for( unsigned i=0; i<N; i++ ){
+    a[i] = i * 3;
+  }
+  for( unsigned i=0; i<N; i++ ){
+    sum += a[(i*17)%N];
+  }
+  assert(sum == 3ull * (N * (N-1) / 2));
+  return 0;
+}
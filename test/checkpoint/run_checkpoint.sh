@@ -0,0 +1,19 @@
+#!/bin/bash
+
+#Build the test
+make
+
+# Check that the exec was built...
+if [ -f checkpoint.exe ]; then
+  # stop part way through the program, then resume from the checkpoint
+  rm -f checkpoint.ckpt
+  sst --add-lib-path=../../src/ ./rev-checkpoint.py || exit 1
+  if [ ! -s checkpoint.ckpt ]; then
+    echo "Test CHECKPOINT: checkpoint.ckpt was not written"
+    exit 1
+  fi
+  sst --add-lib-path=../../src/ ./rev-restore.py
+else
+  echo "Test CHECKPOINT: checkpoint.exe not Found - likely build failed"
+  exit 1
+fi
@@ -0,0 +1,57 @@
+/*
+ * coalesce.c
+ *
+ * RISC-V ISA: RV64IMAFD
+ *
+ * Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ *
+ */
+
+#include <stdint.h>
+
+#define assert(x)                                                              \
+  if (!(x)) {                                                                  \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+  }
+
+#define N 256
+
+int8_t b[N];
+int32_t w[N];
+uint32_t u[N];
+
+int main() {
+  // sequential loads of every width share lines with their neighbours;
+  // each merged read must still be sign or zero extended on its own
+  for( unsigned i=0; i<N; i++ ){
+    b[i] = (int8_t)(i - 128);
+    w[i] = -(int32_t)(i);
+    u[i] = 0x80000000u + i;
+  }
+
+  int64_t sb = 0;
+  int64_t sw = 0;
+  uint64_t su = 0;
+  for( unsigned i=0; i<N; i++ ){
+    sb += b[i];
+    sw += w[i];
+    su += u[i];
+  }
+  assert(sb == -128);
+  assert(sw == -(int64_t)(N * (N-1) / 2));
+  assert(su == (uint64_t)(N) * 0x80000000ull + (N * (N-1) / 2));
+
+  // a store to a line with a fill in flight must be seen by later loads
+  w[3] = 1234;
+  assert(w[2] == -2);
+  assert(w[3] == 1234);
+  assert(w[4] == -4);
+  return 0;
+}
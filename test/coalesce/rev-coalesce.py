@@ -0,0 +1,21 @@
+#
+# Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+# All Rights Reserved
+# contact@tactcomplabs.com
+#
+# See LICENSE in the top level directory for licensing details
+#
+# rev-coalesce.py
+#
+
+import sys
+sys.path.append("..")
+import rev_memctrl
+
+# a small load window keeps the merged reads up against max_loads
+rev_memctrl.build("coalesce", ctrl={
+      "max_loads"       : 4,
+      "coalesce_loads"  : 1
+})
+
+# EOF
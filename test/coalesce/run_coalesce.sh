@@ -0,0 +1,18 @@
+#!/bin/bash
+
+#Build the test
+make
+
+# Check that the exec was built...
+if [ -f coalesce.exe ]; then
+  rm -f coalesce.csv
+  sst --add-lib-path=../../src/ ./rev-coalesce.py || exit 1
+else
+  echo "Test COALESCE: coalesce.exe not Found - likely build failed"
+  exit 1
+fi
+
+# reads must merge into outstanding fills without exceeding max_loads
+../check_stats.sh COALESCE coalesce.csv \
+  "ReadCoalesced > 0" \
+  "ReadOutstanding.Max <= 4"
@@ -0,0 +1,69 @@
+/*
+ * dram.c
+ *
+ * RISC-V ISA: RV64IMAFD
+ *
+ * Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ *
+ */
+
+#include <stdint.h>
+
+#define assert(x)                                                              \
+  if (!(x)) {                                                                  \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+  }
+
+#define N 1024
+#define STRIDE 67
+
+#define ROWS 8
+#define ROW_SET (2048 * 8)
+
+int32_t a[N];
+int64_t b[N];
+uint8_t c[ROWS * ROW_SET];
+uint64_t counter;
+
+int main() {
+  // sequential stores stay in open rows
+  for( unsigned i=0; i<N; i++ ){
+    a[i] = -(int32_t)(i);
+    b[i] = (int64_t)(i) << 32;
+  }
+
+  // a stride that skips rows makes the scheduler reorder around conflicts;
+  // every value must still reflect the program order of the stores
+  int64_t s = 0;
+  unsigned j = 0;
+  for( unsigned i=0; i<N; i++ ){
+    s += a[j];
+    b[j] += 1;
+    j = (j + STRIDE) % N;
+  }
+  assert(s == -((int64_t)(N) * (N - 1)) / 2);
+  for( unsigned i=0; i<N; i++ )
+    assert(b[i] == (((int64_t)(i) << 32) + 1));
+
+  // with rev-dram.py's 2KiB rows and 8 banks, addresses ROW_SET apart
+  // fall in different rows of the same bank; alternating between them
+  // forces a row conflict on every access under the open page policy
+  for( unsigned r=0; r<4*ROWS; r++ )
+    c[(r % ROWS) * ROW_SET] += 1;
+  for( unsigned r=0; r<ROWS; r++ )
+    assert(c[r * ROW_SET] == 4);
+
+  // atomics are read-modify-writes of the backing store
+  for( unsigned i=0; i<64; i++ )
+    __atomic_fetch_add(&counter, i, __ATOMIC_SEQ_CST);
+  assert(counter == (64 * 63) / 2);
+
+  return 0;
+}
@@ -0,0 +1,53 @@
+#
+# Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+# All Rights Reserved
+# contact@tactcomplabs.com
+#
+# See LICENSE in the top level directory for licensing details
+#
+# rev-dram.py
+#
+
+import os
+import sst
+
+MEM_SIZE = 1024*1024*1024-1
+PAGE_POLICY = os.getenv("REV_PAGE_POLICY", "open")
+
+# Define the simulation components
+comp_cpu = sst.Component("cpu", "revcpu.RevCPU")
+comp_cpu.addParams({
+	"verbose" : 6,                                # Verbosity
+        "numCores" : 1,                               # Number of cores
+	"clock" : "2.0GHz",                           # Clock
+        "memSize" : MEM_SIZE,                         # Memory size in bytes
+        "machine" : "[0:RV64IMAFD]",                  # Core:Config; RV64IMAFD for core 0
+        "startAddr" : "[0:0x00000000]",               # Starting address for core 0
+        "memCost" : "[0:1:10]",                       # Memory loads required 1-10 cycles
+        "program" : os.getenv("REV_EXE", "dram.exe"), # Target executable
+        "enable_memH" : 1,                            # Enable the memory controller
+        "splash" : 1                                  # Display the splash message
+})
+comp_cpu.enableAllStatistics()
+
+# Create the RevDRAMCtrl subcomponent; no memHierarchy graph is needed
+comp_dram = comp_cpu.setSubComponent("memory", "revcpu.RevDRAMCtrl");
+comp_dram.addParams({
+      "verbose"       : "10",
+      "clock"         : "1.6Ghz",
+      "banks"         : 8,
+      "row_size"      : 2048,
+      "tRCD"          : 14,
+      "tCAS"          : 14,
+      "tRP"           : 14,
+      "page_policy"   : PAGE_POLICY,
+      "bus_bytes"     : 16,
+      "sched_window"  : 16,
+      "ops_per_cycle" : 2
+})
+comp_dram.enableAllStatistics({"type":"sst.AccumulatorStatistic"})
+
+sst.setStatisticLoadLevel(4)
+sst.setStatisticOutput("sst.statOutputCSV", {"filepath" : "dram-" + PAGE_POLICY + ".csv", "separator" : ","})
+
+# EOF
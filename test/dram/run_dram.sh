@@ -0,0 +1,32 @@
+#!/bin/bash
+
+#Build the test
+make
+
+# Check that the exec was built...
+if [ ! -f dram.exe ]; then
+  echo "Test DRAM: dram.exe not Found - likely build failed"
+  exit 1
+fi
+
+# run the program under both row buffer policies
+for POLICY in open closed; do
+  rm -f dram-$POLICY.csv
+  REV_PAGE_POLICY=$POLICY sst --add-lib-path=../../src/ ./rev-dram.py || exit 1
+done
+
+# an open row serves later accesses to it and must be closed before
+# another row of its bank is opened
+../check_stats.sh DRAM dram-open.csv \
+  "RowHits > 0" \
+  "RowConflicts > 0" \
+  "BusBusy > 0" \
+  "ReadLatency > 0" || exit 1
+
+# a closed page policy precharges after every access, so every
+# transaction finds its bank precharged
+../check_stats.sh DRAM dram-closed.csv \
+  "RowHits == 0" \
+  "RowConflicts == 0" \
+  "RowEmpty > 0" \
+  "BusBusy > 0"
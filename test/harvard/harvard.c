@@ -0,0 +1,62 @@
+/*
+ * harvard.c
+ *
+ * RISC-V ISA: RV64IMAFD
+ *
+ * Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ *
+ */
+
+#include <stdint.h>
+
+#define assert(x)                                                              \
+  if (!(x)) {                                                                  \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+  }
+
+#define N 512
+
+uint64_t a[N];
+
+// code spread over several functions keeps the instruction fetch
+// stream busy while the data loads and stores go through the L1D
+uint64_t __attribute__((noinline)) mix(uint64_t x) {
+  x ^= x >> 7;
+  x *= 0x9E3779B97F4A7C15ull;
+  return x ^ (x >> 13);
+}
+
+uint64_t __attribute__((noinline)) fill(unsigned n) {
+  uint64_t s = 0;
+  for( unsigned i=0; i<n; i++ ){
+    a[i] = mix(i);
+    s += a[i];
+  }
+  return s;
+}
+
+uint64_t __attribute__((noinline)) sum(unsigned n) {
+  uint64_t s = 0;
+  for( unsigned i=0; i<n; i++ )
+    s += a[i];
+  return s;
+}
+
+int main() {
+  uint64_t s = fill(N);
+  assert(sum(N) == s);
+
+  // rewrite the data and read it back through the same functions
+  for( unsigned i=0; i<N; i++ )
+    a[i] = i;
+  assert(sum(N) == ((uint64_t)(N) * (N - 1)) / 2);
+
+  return 0;
+}
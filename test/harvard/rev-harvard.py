@@ -0,0 +1,146 @@
+#
+# Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+# All Rights Reserved
+# contact@tactcomplabs.com
+#
+# See LICENSE in the top level directory for licensing details
+#
+# rev-harvard.py
+#
+
+import os
+import sst
+
+DEBUG_L1 = 1
+DEBUG_MEM = 10
+DEBUG_LEVEL = 10
+VERBOSE = 10
+MEM_SIZE = 1024*1024*1024-1
+
+# Define the simulation components
+comp_cpu = sst.Component("cpu", "revcpu.RevCPU")
+comp_cpu.addParams({
+	"verbose" : 6,                                # Verbosity
+        "numCores" : 1,                               # Number of cores
+	"clock" : "2.0GHz",                           # Clock
+        "memSize" : MEM_SIZE,                         # Memory size in bytes
+        "machine" : "[0:RV64IMAFD]",                  # Core:Config; RV64IMAFD for core 0
+        "startAddr" : "[0:0x00000000]",               # Starting address for core 0
+        "memCost" : "[0:1:10]",                       # Memory loads required 1-10 cycles
+        "program" : os.getenv("REV_EXE", "harvard.exe"),  # Target executable
+        "enable_memH" : 1,                            # Enable memHierarchy support
+        "splash" : 1                                  # Display the splash message
+})
+comp_cpu.enableAllStatistics()
+
+# Create the RevMemCtrl subcomponent
+comp_lsq = comp_cpu.setSubComponent("memory", "revcpu.RevBasicMemCtrl");
+comp_lsq.addParams({
+      "verbose"         : "10",
+      "clock"           : "2.0Ghz",
+      "max_loads"       : 64,
+      "max_stores"      : 64,
+      "max_flush"       : 64,
+      "max_llsc"        : 64,
+      "max_readlock"    : 64,
+      "max_writeunlock" : 64,
+      "max_custom"      : 64,
+      "ops_per_cycle"   : 64
+})
+comp_lsq.enableAllStatistics({"type":"sst.AccumulatorStatistic"})
+
+iface = comp_lsq.setSubComponent("memIface", "memHierarchy.standardInterface")
+iface.addParams({
+      "verbose" : VERBOSE
+})
+
+# instruction fetch uses its own interface and L1I
+iiface = comp_lsq.setSubComponent("instIface", "memHierarchy.standardInterface")
+iiface.addParams({
+      "verbose" : VERBOSE
+})
+
+l1dcache = sst.Component("l1dcache", "memHierarchy.Cache")
+l1dcache.addParams({
+    "access_latency_cycles" : "4",
+    "cache_frequency" : "2 Ghz",
+    "replacement_policy" : "lru",
+    "coherence_protocol" : "MESI",
+    "associativity" : "4",
+    "cache_line_size" : "64",
+    "debug" : 1,
+    "debug_level" : DEBUG_LEVEL,
+    "verbose" : VERBOSE,
+    "L1" : "1",
+    "cache_size" : "16KiB"
+})
+
+l1icache = sst.Component("l1icache", "memHierarchy.Cache")
+l1icache.addParams({
+    "access_latency_cycles" : "2",
+    "cache_frequency" : "2 Ghz",
+    "replacement_policy" : "lru",
+    "coherence_protocol" : "MESI",
+    "associativity" : "4",
+    "cache_line_size" : "64",
+    "debug" : 1,
+    "debug_level" : DEBUG_LEVEL,
+    "verbose" : VERBOSE,
+    "L1" : "1",
+    "cache_size" : "16KiB"
+})
+
+l1bus = sst.Component("l1bus", "memHierarchy.Bus")
+l1bus.addParams({
+    "bus_frequency" : "2 Ghz"
+})
+
+l2cache = sst.Component("l2cache", "memHierarchy.Cache")
+l2cache.addParams({
+    "access_latency_cycles" : "10",
+    "cache_frequency" : "2 Ghz",
+    "replacement_policy" : "lru",
+    "coherence_protocol" : "MESI",
+    "associativity" : "8",
+    "cache_line_size" : "64",
+    "debug" : 1,
+    "debug_level" : DEBUG_LEVEL,
+    "verbose" : VERBOSE,
+    "cache_size" : "128KiB"
+})
+
+memctrl = sst.Component("memory", "memHierarchy.MemController")
+memctrl.addParams({
+    "debug" : DEBUG_MEM,
+    "debug_level" : DEBUG_LEVEL,
+    "clock" : "2GHz",
+    "verbose" : VERBOSE,
+    "addr_range_start" : 0,
+    "addr_range_end" : MEM_SIZE,
+    "backing" : "malloc"
+})
+
+memory = memctrl.setSubComponent("backend", "memHierarchy.simpleMem")
+memory.addParams({
+    "access_time" : "100ns",
+    "mem_size" : "8GB"
+})
+
+#sst.setStatisticLoadLevel(7)
+#sst.setStatisticOutput("sst.statOutputConsole")
+#sst.enableAllStatisticsForAllComponents()
+
+link1 = sst.Link("link1")
+link1.connect( (iface, "port", "1ns"), (l1dcache, "high_network_0", "1ns") )
+link2 = sst.Link("link2")
+link2.connect( (iiface, "port", "1ns"), (l1icache, "high_network_0", "1ns") )
+link3 = sst.Link("link3")
+link3.connect( (l1dcache, "low_network_0", "1ns"), (l1bus, "high_network_0", "1ns") )
+link4 = sst.Link("link4")
+link4.connect( (l1icache, "low_network_0", "1ns"), (l1bus, "high_network_1", "1ns") )
+link5 = sst.Link("link5")
+link5.connect( (l1bus, "low_network_0", "1ns"), (l2cache, "high_network_0", "1ns") )
+link6 = sst.Link("link6")
+link6.connect( (l2cache, "low_network_0", "1ns"), (memctrl, "direct_link", "1ns") )
+
+# EOF
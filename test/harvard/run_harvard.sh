@@ -0,0 +1,12 @@
+#!/bin/bash
+
+#Build the test
+make
+
+# Check that the exec was built...
+if [ -f harvard.exe ]; then
+  sst --add-lib-path=../../src/ ./rev-harvard.py
+else
+  echo "Test HARVARD: harvard.exe not Found - likely build failed"
+  exit 1
+fi
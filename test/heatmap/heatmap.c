@@ -0,0 +1,49 @@
+/*
+ * heatmap.c
+ *
+ * RISC-V ISA: RV64IMAFD
+ *
+ * Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ *
+ */
+
+#include <stdint.h>
+
+#define assert(x)                                                              \
+  if (!(x)) {                                                                  \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+  }
+
+#define N 16384
+#define WORDS 1024
+
+// each array fills its own 4KiB page
+uint32_t a[WORDS] __attribute__((aligned(4096)));
+uint32_t b[WORDS] __attribute__((aligned(4096)));
+
+int main() {
+  // phase 1: only a is hot
+  for( unsigned i=0; i<N; i++ ){
+    a[i % WORDS]++;
+  }
+
+  // phase 2: b is hot while a is barely touched; interval dumps must
+  // rank b above a even though a has far more lifetime accesses
+  for( unsigned i=0; i<N; i++ ){
+    b[i % WORDS]++;
+    if( (i % 64) == 0 )
+      a[0]++;
+  }
+
+  assert(a[1] == N/WORDS);
+  assert(b[1] == N/WORDS);
+  assert(a[0] == (N/WORDS) + (N/64));
+  return 0;
+}
@@ -0,0 +1,42 @@
+#!/bin/bash
+
+#Build the test
+make
+
+# Check that the exec was built...
+if [ -f heatmap.exe ]; then
+  rm -f heatmap.heat
+  sst --add-lib-path=../../src/ ./rev-heatmap.py || exit 1
+else
+  echo "Test HEATMAP: heatmap.exe not Found - likely build failed"
+  exit 1
+fi
+
+# interval dumps must rank pages by their accesses during the interval,
+# and at least one of them must differ from the lifetime ranking; the
+# final dump ranks pages by their lifetime accesses
+if ! awk '
+     function close_dump(){
+       if( !Dump ) return
+       IvlSorted[Dump] = IvlOk; LifeSorted[Dump] = LifeOk
+     }
+     /^W/ { close_dump(); Dump++; IvlOk = 1; LifeOk = 1; PrevIvl = -1; PrevLife = -1; next }
+     /^H/ {
+       Life = $5 + $6
+       if( (PrevIvl >= 0) && ($11 > PrevIvl) ) IvlOk = 0
+       if( (PrevLife >= 0) && (Life > PrevLife) ) LifeOk = 0
+       PrevIvl = $11; PrevLife = Life
+     }
+     END {
+       close_dump()
+       if( Dump < 2 || !LifeSorted[Dump] ) exit 1
+       Differs = 0
+       for( d=1; d<Dump; d++ ){
+         if( !IvlSorted[d] ) exit 1
+         if( !LifeSorted[d] ) Differs = 1
+       }
+       exit !Differs
+     }' heatmap.heat; then
+  echo "Test HEATMAP: CHECK FAILED: heat map dumps are not ranked by interval accesses"
+  exit 1
+fi
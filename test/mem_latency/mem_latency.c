@@ -0,0 +1,41 @@
+/*
+ * mem_latency.c
+ *
+ * RISC-V ISA: RV64IMAFD
+ *
+ * Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ *
+ */
+
+#include <stdint.h>
+
+#define assert(x)                                                              \
+  if (!(x)) {                                                                  \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+  }
+
+#define N 512
+
+uint64_t a[N];
+
+int main() {
+  // strided writes and reads miss in the L1, so every class of request
+  // spends time in the controller queue and in the memory system
+  for( unsigned i=0; i<N; i++ ){
+    a[(i * 8) % N] = i;
+  }
+
+  uint64_t sum = 0;
+  for( unsigned i=0; i<N; i++ ){
+    sum += a[(i * 8) % N];
+  }
+  assert(sum == (uint64_t)(N) * (N-1) / 2);
+  return 0;
+}
@@ -0,0 +1,20 @@
+#
+# Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+# All Rights Reserved
+# contact@tactcomplabs.com
+#
+# See LICENSE in the top level directory for licensing details
+#
+# rev-mem-latency.py
+#
+
+import sys
+sys.path.append("..")
+import rev_memctrl
+
+# a narrow issue window makes requests wait in the controller queue
+rev_memctrl.build("mem_latency", ctrl={
+      "ops_per_cycle"   : 1
+})
+
+# EOF
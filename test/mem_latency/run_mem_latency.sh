@@ -0,0 +1,25 @@
+#!/bin/bash
+
+#Build the test
+make
+
+# Check that the exec was built...
+if [ -f mem_latency.exe ]; then
+  rm -f mem_latency.csv
+  sst --add-lib-path=../../src/ ./rev-mem-latency.py || exit 1
+else
+  echo "Test MEM_LATENCY: mem_latency.exe not Found - likely build failed"
+  exit 1
+fi
+
+# every read and write is timed per class and again for the core that
+# issued it; with a single core both views must count the same requests
+../check_stats.sh MEM_LATENCY mem_latency.csv \
+  "ReadLatency > 0" \
+  "WriteLatency > 0" \
+  "ReadLatency:core0 > 0" \
+  "WriteLatency:core0 > 0" \
+  "ReadLatency:core0.Count == ReadLatency.Count" \
+  "WriteLatency:core0.Count == WriteLatency.Count" \
+  "ReadQueueDelay:core0.Count == ReadLatency:core0.Count" \
+  "ReadLatency.Max >= ReadLatency:core0.Max"
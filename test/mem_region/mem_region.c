@@ -0,0 +1,60 @@
+/*
+ * mem_region.c
+ *
+ * RISC-V ISA: RV64IMAFD
+ *
+ * Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ *
+ */
+
+#include <stdint.h>
+
+#define assert(x)                                                              \
+  if (!(x)) {                                                                  \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+  }
+
+// must match the regions configured in rev-mem-region.py
+#define SCRATCH_BASE 0x20000000ull
+#define SCRATCH_SIZE 0x10000ull
+#define N 64
+
+int main() {
+  volatile uint64_t *scratch = (volatile uint64_t *)(SCRATCH_BASE);
+
+  // a burst of doublewords issued back to back; each one occupies the
+  // scratchpad for longer than it takes to issue the next
+  asm volatile("sd zero, 0(%0)\n\t"
+               "sd zero, 8(%0)\n\t"
+               "sd zero, 16(%0)\n\t"
+               "sd zero, 24(%0)\n\t"
+               "sd zero, 32(%0)\n\t"
+               "sd zero, 40(%0)\n\t"
+               "sd zero, 48(%0)\n\t"
+               "sd zero, 56(%0)"
+               : : "r"(scratch) : "memory");
+
+  for( unsigned i=0; i<N; i++ ){
+    scratch[i] = i;
+  }
+
+  uint64_t sum = 0;
+  for( unsigned i=0; i<N; i++ ){
+    sum += scratch[i];
+  }
+  assert(sum == (uint64_t)(N) * (N-1) / 2);
+
+  // a doubleword straddling the end of the scratchpad and the start of
+  // the region that follows it
+  volatile uint64_t *edge = (volatile uint64_t *)(SCRATCH_BASE + SCRATCH_SIZE - 4);
+  *edge = 0x0123456789abcdefull;
+  assert(*edge == 0x0123456789abcdefull);
+  return 0;
+}
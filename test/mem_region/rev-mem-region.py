@@ -0,0 +1,40 @@
+#
+# Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+# All Rights Reserved
+# contact@tactcomplabs.com
+#
+# See LICENSE in the top level directory for licensing details
+#
+# rev-mem-region.py
+#
+
+import os
+import sst
+
+# Define SST core options
+sst.setProgramOption("timebase", "1ps")
+
+# Tell SST what statistics handling we want
+sst.setStatisticLoadLevel(4)
+
+# Define the simulation components
+comp_cpu = sst.Component("cpu", "revcpu.RevCPU")
+comp_cpu.addParams({
+	"verbose" : 6,                                # Verbosity
+        "numCores" : 1,                               # Number of cores
+	"clock" : "1.0GHz",                           # Clock
+        "memSize" : 1024*1024*1024,                   # Memory size in bytes
+        "machine" : "[0:RV64IMAFD]",                  # Core:Config; RV64IMAFD for core 0
+        "startAddr" : "[0:0x00000000]",               # Starting address for core 0
+        "memCost" : "[0:1:10]",                       # Memory loads required 1-10 cycles
+        # a 64KiB scratchpad moving one byte per cycle, followed by an
+        # unpaced region; Base:Size:Min:Max[:BytesPerCycle]
+        "memRegions" : "[0x20000000:0x10000:2:2:1,0x20010000:0x10000:1:1]",
+        "program" : os.getenv("REV_EXE", "mem_region.exe"),  # Target executable
+        "splash" : 1                                  # Display the splash message
+})
+
+sst.setStatisticOutput("sst.statOutputCSV", {"filepath" : "mem_region.csv", "separator" : ","})
+sst.enableAllStatisticsForAllComponents()
+
+# EOF
@@ -0,0 +1,21 @@
+#!/bin/bash
+
+#Build the test
+make
+
+# Check that the exec was built...
+if [ -f mem_region.exe ]; then
+  rm -f mem_region.csv
+  sst --add-lib-path=../../src/ ./rev-mem-region.py || exit 1
+else
+  echo "Test MEM_REGION: mem_region.exe not Found - likely build failed"
+  exit 1
+fi
+
+# the scratchpad sees the 8 store burst followed by N stores and N loads;
+# the straddling store and load are charged to both regions they touch.
+# The burst moves doublewords faster than one byte per cycle allows, so
+# it must wait on the scratchpad bandwidth.
+../check_stats.sh MEM_REGION mem_region.csv \
+  "RegionAccessesPerCore:core_0 == 138" \
+  "RegionStallsPerCore:core_0 > 0"
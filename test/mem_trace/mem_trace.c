@@ -0,0 +1,30 @@
+/*
+ * mem_trace.c
+ *
+ * RISC-V ISA: RV64IMAFD
+ *
+ * Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ *
+ */
+
+#include <stdint.h>
+
+#define N 1024
+
+uint64_t a[N];
+uint64_t b[N];
+
+int main() {
+  for( unsigned i=0; i<N; i++ ){
+    a[i] = i;
+  }
+  for( unsigned i=0; i<N; i++ ){
+    b[(i*17)%N] = a[i];
+  }
+  __atomic_fetch_add(&a[0], b[1], __ATOMIC_SEQ_CST);
+  return 0;
+}
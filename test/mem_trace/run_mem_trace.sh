@@ -0,0 +1,19 @@
+#!/bin/bash
+
+#Build the test
+make
+
+# Check that the exec was built...
+if [ -f mem_trace.exe ]; then
+  # record the trace, then replay it without executing the program
+  rm -f mem_trace.trc
+  sst --add-lib-path=../../src/ ./rev-mem-trace.py || exit 1
+  if [ ! -s mem_trace.trc ]; then
+    echo "Test MEM_TRACE: mem_trace.trc was not written"
+    exit 1
+  fi
+  sst --add-lib-path=../../src/ ./rev-mem-replay.py
+else
+  echo "Test MEM_TRACE: mem_trace.exe not Found - likely build failed"
+  exit 1
+fi
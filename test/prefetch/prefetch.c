@@ -0,0 +1,52 @@
+/*
+ * prefetch.c
+ *
+ * RISC-V ISA: RV64IMAFD
+ *
+ * Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ *
+ */
+
+#include <stdint.h>
+
+#define assert(x)                                                              \
+  if (!(x)) {                                                                  \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+  }
+
+#define N 2048
+
+double x[N];
+double y[N];
+
+int main() {
+  for( unsigned i=0; i<N; i++ ){
+    x[i] = (double)(i);
+    y[i] = 2.0;
+  }
+
+  // unit stride dot product, then a strided walk that crosses lines
+  double dot = 0.0;
+  for( unsigned i=0; i<N; i++ ){
+    dot += x[i] * y[i];
+  }
+  assert(dot == (double)(N) * (double)(N-1));
+
+  double sum = 0.0;
+  for( unsigned i=0; i<N; i+=24 ){
+    sum += x[i];
+  }
+  double expect = 0.0;
+  for( unsigned i=0; i<N; i+=24 ){
+    expect += (double)(i);
+  }
+  assert(sum == expect);
+  return 0;
+}
@@ -0,0 +1,24 @@
+#
+# Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+# All Rights Reserved
+# contact@tactcomplabs.com
+#
+# See LICENSE in the top level directory for licensing details
+#
+# rev-prefetch.py
+#
+
+import sys
+sys.path.append("..")
+import rev_memctrl
+
+# attach a per-PC stride data prefetcher; a small load window keeps
+# the prefetches up against max_loads
+rev_memctrl.build("prefetch", ctrl={
+      "max_loads"       : 8
+}, prefetcher=("revcpu.RevStridePrefetcher", {
+      "degree"          : 4,
+      "table_size"      : 64
+}))
+
+# EOF
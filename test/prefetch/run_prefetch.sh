@@ -0,0 +1,22 @@
+#!/bin/bash
+
+#Build the test
+make
+
+# Check that the exec was built...
+if [ -f prefetch.exe ]; then
+  rm -f prefetch.csv
+  sst --add-lib-path=../../src/ ./rev-prefetch.py || exit 1
+else
+  echo "Test PREFETCH: prefetch.exe not Found - likely build failed"
+  exit 1
+fi
+
+# the prefetcher must issue lines that demand reads later use, and
+# neither prefetches nor demand reads may exceed max_loads
+../check_stats.sh PREFETCH prefetch.csv \
+  "PrefetchIssued > 0" \
+  "PrefetchUseful > 0" \
+  "PrefetchUseful <= PrefetchIssued" \
+  "PrefetchOutstanding.Max <= 8" \
+  "ReadOutstanding.Max <= 8"
@@ -0,0 +1,109 @@
+#
+# Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+# All Rights Reserved
+# contact@tactcomplabs.com
+#
+# See LICENSE in the top level directory for licensing details
+#
+# rev_memctrl.py
+#
+# Shared configuration for the RevBasicMemCtrl tests: one core behind
+# the controller, an L1 and a memHierarchy memory.  Each test passes
+# its program, the controller parameters it changes and an optional
+# prefetcher; statistics are written to <name>.csv for check_stats.sh.
+#
+
+import os
+import sst
+
+DEBUG_L1 = 1
+DEBUG_MEM = 10
+DEBUG_LEVEL = 10
+VERBOSE = 10
+MEM_SIZE = 1024*1024*1024-1
+
+def build(name, ctrl={}, prefetcher=None):
+  # Define the simulation components
+  comp_cpu = sst.Component("cpu", "revcpu.RevCPU")
+  comp_cpu.addParams({
+        "verbose" : 6,                                # Verbosity
+        "numCores" : 1,                               # Number of cores
+        "clock" : "2.0GHz",                           # Clock
+        "memSize" : MEM_SIZE,                         # Memory size in bytes
+        "machine" : "[0:RV64IMAFD]",                  # Core:Config; RV64IMAFD for core 0
+        "startAddr" : "[0:0x00000000]",               # Starting address for core 0
+        "memCost" : "[0:1:10]",                       # Memory loads required 1-10 cycles
+        "program" : os.getenv("REV_EXE", name + ".exe"),  # Target executable
+        "enable_memH" : 1,                            # Enable memHierarchy support
+        "splash" : 1                                  # Display the splash message
+  })
+  comp_cpu.enableAllStatistics()
+
+  # Create the RevMemCtrl subcomponent
+  params = {
+        "verbose"         : "10",
+        "clock"           : "2.0Ghz",
+        "max_loads"       : 64,
+        "max_stores"      : 64,
+        "max_flush"       : 64,
+        "max_llsc"        : 64,
+        "max_readlock"    : 64,
+        "max_writeunlock" : 64,
+        "max_custom"      : 64,
+        "ops_per_cycle"   : 64
+  }
+  params.update(ctrl)
+  comp_lsq = comp_cpu.setSubComponent("memory", "revcpu.RevBasicMemCtrl");
+  comp_lsq.addParams(params)
+  comp_lsq.enableAllStatistics({"type":"sst.AccumulatorStatistic"})
+
+  if prefetcher:
+    comp_pf = comp_lsq.setSubComponent("prefetcher", prefetcher[0])
+    comp_pf.addParams(prefetcher[1])
+
+  iface = comp_lsq.setSubComponent("memIface", "memHierarchy.standardInterface")
+  iface.addParams({
+        "verbose" : VERBOSE
+  })
+
+  l1cache = sst.Component("l1cache", "memHierarchy.Cache")
+  l1cache.addParams({
+      "access_latency_cycles" : "4",
+      "cache_frequency" : "2 Ghz",
+      "replacement_policy" : "lru",
+      "coherence_protocol" : "MESI",
+      "associativity" : "4",
+      "cache_line_size" : "64",
+      "debug" : DEBUG_L1,
+      "debug_level" : DEBUG_LEVEL,
+      "verbose" : VERBOSE,
+      "L1" : "1",
+      "cache_size" : "16KiB"
+  })
+
+  memctrl = sst.Component("memory", "memHierarchy.MemController")
+  memctrl.addParams({
+      "debug" : DEBUG_MEM,
+      "debug_level" : DEBUG_LEVEL,
+      "clock" : "2GHz",
+      "verbose" : VERBOSE,
+      "addr_range_start" : 0,
+      "addr_range_end" : MEM_SIZE,
+      "backing" : "malloc"
+  })
+
+  memory = memctrl.setSubComponent("backend", "memHierarchy.simpleMem")
+  memory.addParams({
+      "access_time" : "100ns",
+      "mem_size" : "8GB"
+  })
+
+  sst.setStatisticLoadLevel(4)
+  sst.setStatisticOutput("sst.statOutputCSV", {"filepath" : name + ".csv", "separator" : ","})
+
+  link1 = sst.Link("link1")
+  link1.connect( (iface, "port", "1ns"), (l1cache, "high_network_0", "1ns") )
+  link2 = sst.Link("link2")
+  link2.connect( (l1cache, "low_network_0", "1ns"), (memctrl, "direct_link", "1ns") )
+
+# EOF
@@ -0,0 +1,21 @@
+#
+# Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+# All Rights Reserved
+# contact@tactcomplabs.com
+#
+# See LICENSE in the top level directory for licensing details
+#
+# rev-wbuf.py
+#
+
+import sys
+sys.path.append("..")
+import rev_memctrl
+
+# a small store window keeps the drains up against max_stores
+rev_memctrl.build("wbuf", ctrl={
+      "max_stores"      : 4,
+      "wbuf_entries"    : 8
+})
+
+# EOF
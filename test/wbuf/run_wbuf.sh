@@ -0,0 +1,20 @@
+#!/bin/bash
+
+#Build the test
+make
+
+# Check that the exec was built...
+if [ -f wbuf.exe ]; then
+  rm -f wbuf.csv
+  sst --add-lib-path=../../src/ ./rev-wbuf.py || exit 1
+else
+  echo "Test WBUF: wbuf.exe not Found - likely build failed"
+  exit 1
+fi
+
+# stores must gather in the buffer, loads must be forwarded from it
+# and the drains must stay within max_stores
+../check_stats.sh WBUF wbuf.csv \
+  "WriteBufMerged > 0" \
+  "WriteBufForward > 0" \
+  "WriteOutstanding.Max <= 4"
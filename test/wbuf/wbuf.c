@@ -0,0 +1,58 @@
+/*
+ * wbuf.c
+ *
+ * RISC-V ISA: RV64IMAFD
+ *
+ * Copyright (C) 2017-2023 Tactical Computing Laboratories, LLC
+ * All Rights Reserved
+ * contact@tactcomplabs.com
+ *
+ * See LICENSE in the top level directory for licensing details
+ *
+ */
+
+#include <stdint.h>
+
+#define assert(x)                                                              \
+  if (!(x)) {                                                                  \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+    asm(".byte 0x00");                                                         \
+  }
+
+#define N 1024
+
+uint8_t b[N];
+uint64_t d[N/8];
+
+int main() {
+  // byte stores gather into whole lines before they drain
+  for( unsigned i=0; i<N; i++ ){
+    b[i] = (uint8_t)(i * 7);
+  }
+
+  // loads immediately behind stores are forwarded from the buffer
+  for( unsigned i=0; i<N/8; i++ ){
+    d[i] = i;
+    assert(d[i] == i);
+  }
+
+  // a load that only partly overlaps buffered bytes reads the merged line
+  ((volatile uint8_t *)(d))[1] = 0xAA;
+  uint64_t v = *(volatile uint64_t *)(&d[0]);
+  assert(v == 0xAA00);
+
+  // everything must be visible after a fence
+  asm volatile("fence" ::: "memory");
+  unsigned sum = 0;
+  for( unsigned i=0; i<N; i++ ){
+    sum += b[i];
+  }
+  unsigned expect = 0;
+  for( unsigned i=0; i<N; i++ ){
+    expect += (uint8_t)(i * 7);
+  }
+  assert(sum == expect);
+  return 0;
+}